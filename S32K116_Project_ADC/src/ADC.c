@@ -32,6 +32,22 @@
 
 #include "ADC.h"
 
+/* Complete a write to the NVIC before the next instruction runs: ICER takes effect
+ * only once the write has left the bus, so a pending ADC0 interrupt could still be
+ * taken inside the masked section without it. */
+#define ADC_NVIC_SYNC()	__asm volatile ("dsb 0xF\n\tisb 0xF" : : : "memory")
+
+/* Conversion request waiting in the ADC queue */
+typedef struct
+{
+	uint8_t 	   adc_channel;
+	ADC_callback_t callback;
+}ADC_request_t;
+
+static ADC_request_t ADC_queue[ADC_QUEUE_SIZE];
+static uint8_t volatile ADC_queue_head = 0;						/* Requests added, free running */
+static uint8_t volatile ADC_queue_tail = 0;						/* Requests converted, free running */
+
 void ADC_init(void)
 {
 	/*!
@@ -107,6 +123,109 @@ uint32_t read_adc_chx(void)
 {
   uint16_t adc_result=0;
   adc_result=ADC0->R[0];      					/* For SW trigger mode, R[0] is used 	*/
-  return  (uint32_t) ((5000*adc_result)/0xFFF); /* Convert result to mv for 0-5V range */
+  return  ADC_raw_to_mV(adc_result);	/* Convert result to mv for 0-5V range */
+}
+
+/*!
+* @brief Convert a 12-bit result to mV for 0-5 V range. The M0+ has no
+* divider, so the result is scaled by a constant factor and a shift.
+*
+* @param[uint16_t adc_raw_result] Result register value.
+*
+* @return[uint32_t] ADC result in mV.
+*/
+uint32_t ADC_raw_to_mV (uint16_t adc_raw_result)
+{
+	return ((uint32_t) adc_raw_result * ADC_MV_FACTOR(5000, 12) + ADC_MV_ROUND) >> ADC_MV_SHIFT;
+}
+
+/*!
+* @brief Start the conversion of the oldest request of the queue, with the
+* conversion complete interrupt enabled.
+*/
+static void ADC_queue_start (void)
+{
+	ADC0 -> SC1[0] = ADC_SC1_ADCH(ADC_queue[ADC_queue_tail & (ADC_QUEUE_SIZE - 1)].adc_channel)
+				   | ADC_SC1_AIEN_MASK;							/* AIEN = 1 COCO interrupt, conversion starts (SW trigger) */
+}
+
+/*!
+* @brief Initialize the conversion queue. The ADC must be initialized for SW
+* trigger first (ADC_init), ADC0_IRQHandler must
+* call ADC_queue_IRQ.
+*/
+void ADC_queue_init (void)
+{
+	ADC_queue_head = 0;
+	ADC_queue_tail = 0;
+
+	S32_NVIC -> ICPR[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* ADC0: clr any pending IRQ */
+	S32_NVIC -> ISER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* ADC0: enable IRQ */
+}
+
+/*!
+* @brief Add a conversion to the queue. The conversion starts at once if the
+* ADC is idle, otherwise when the previous requests are done. The function
+* does not wait: the callback gets the result from the ADC0 interrupt.
+*
+* @param[uint8_t adc_channel] ADC Channel.
+* @param[ADC_callback_t callback] Called with the channel and the raw result, can be 0.
+*
+* @return 1 if the request was queued, 0 if the queue is full.
+*/
+uint8_t ADC_queue_request (uint8_t adc_channel, ADC_callback_t callback)
+{
+	uint8_t queued = 0;
+
+	S32_NVIC -> ICER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* The ISR must not pop while a request is added */
+	ADC_NVIC_SYNC();												/* Masked before the queue is touched */
+
+	if ((uint8_t)(ADC_queue_head - ADC_queue_tail) < ADC_QUEUE_SIZE)
+	{
+		ADC_queue[ADC_queue_head & (ADC_QUEUE_SIZE - 1)].adc_channel = adc_channel;
+		ADC_queue[ADC_queue_head & (ADC_QUEUE_SIZE - 1)].callback = callback;
+		ADC_queue_head++;
+
+		if ((uint8_t)(ADC_queue_head - ADC_queue_tail) == 1u)
+		{
+			ADC_queue_start();									/* ADC was idle */
+		}
+		queued = 1;
+	}
+
+	S32_NVIC -> ISER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);
+
+	return queued;
+}
+
+/*!
+* @brief Number of requests in the queue, including the one being converted.
+*/
+uint8_t ADC_queue_pending (void)
+{
+	return (uint8_t)(ADC_queue_head - ADC_queue_tail);
+}
+
+/*!
+* @brief Conversion complete of a queued request, to be called from
+* ADC0_IRQHandler. The next request is started before the callback runs, so
+* the ADC converts while the result is processed. The callback may queue new
+* requests.
+*/
+void ADC_queue_IRQ (void)
+{
+	ADC_request_t request = ADC_queue[ADC_queue_tail & (ADC_QUEUE_SIZE - 1)];
+	uint16_t adc_raw_result = ADC0 -> R[0];						/* Reading R[0] clears COCO */
+
+	ADC_queue_tail++;
+	if (ADC_queue_head != ADC_queue_tail)
+	{
+		ADC_queue_start();
+	}
+
+	if (request.callback != 0)
+	{
+		request.callback(request.adc_channel, adc_raw_result);
+	}
 }
 
@@ -34,10 +34,25 @@
 #define ADC_H_
 #include "device_registers.h"	/* include peripheral declarations S32K116 */
 
+#define ADC_QUEUE_SIZE	8		/* Requests of the conversion queue, power of 2 */
+
+/* Result to mV without divisions: mV = (raw * factor + ADC_MV_ROUND) >> ADC_MV_SHIFT */
+#define ADC_MV_SHIFT	18		/* Fraction bits of the factor, raw * factor fits in 32 bits up to 12-bit results */
+#define ADC_MV_ROUND	(1u << (ADC_MV_SHIFT - 1))
+#define ADC_MV_FACTOR(vref_mV, bits)	((((uint32_t)(vref_mV) << ADC_MV_SHIFT) + ((1u << (bits)) - 1u) / 2u) / ((1u << (bits)) - 1u))
+
+/* Result of a queued conversion, called from the ADC0 interrupt */
+typedef void (*ADC_callback_t)(uint8_t adc_channel, uint16_t adc_raw_result);
+
 void convertAdcChan(uint16_t);
 void ADC_init(void);
 void ADC_init_HWTrigger(char Channel);
 uint8_t adc_complete(void);
 uint32_t read_adc_chx(void);
+uint32_t ADC_raw_to_mV(uint16_t adc_raw_result);
+void ADC_queue_init(void);
+uint8_t ADC_queue_request(uint8_t adc_channel, ADC_callback_t callback);
+uint8_t ADC_queue_pending(void);
+void ADC_queue_IRQ(void);
 
 #endif /* ADC_H_ */
@@ -37,6 +37,8 @@
  * that are configured for one-shot conversions. Each conversion requires
  * its own software trigger. One channel (AD3) connects to a potentiometer
  * on the EVB the other to VREFSH. The results are scaled 0 to 5000 mV.
+ * The conversions are queued: the ADC0 interrupt delivers each result and
+ * starts the next request, the core does not wait for the ADC.
  */
 
 #include "device_registers.h"
@@ -46,6 +48,22 @@
 #define PTD16 (16)	/* Port D16: FRDM EVB output to red LED 	*/
 #define PTD15 (15) 	/* Port D15: FRDM EVB output to green LED 	*/
 
+uint32_t volatile adcResultInMv=0;	/*< Pot (AD3) result in miliVolts */
+uint32_t volatile vrefshInMv=0;		/*< VREFSH (AD29) result in miliVolts */
+
+/*!
+ * Result of a queued conversion, from the ADC0 interrupt.
+ */
+void ADC_result_ready (uint8_t adc_channel, uint16_t adc_raw_result)
+{
+  if (adc_channel == 3) {
+	adcResultInMv = ADC_raw_to_mV(adc_raw_result);
+  }
+  else {
+	vrefshInMv = ADC_raw_to_mV(adc_raw_result);
+  }
+}
+
 void PORT_init (void)
 {
 	/*!
@@ -78,8 +96,6 @@ void WDOG_disable (void)
 
 int main(void)
 {
-  uint32_t adcResultInMv=0;	/*< ADC0 Result in miliVolts */
-
 	/*!
 	 * Initialization:
 	 * =======================
@@ -90,6 +106,7 @@ int main(void)
   RUN_mode_48MHz(); /* Init clocks: 80 MHz sysclk & core, 40 MHz bus, 20 MHz flash*/
   PORT_init();		     /* Init  port clocks and gpio outputs 						*/
   ADC_init();            /* Init ADC resolution 12 bit									*/
+  ADC_queue_init();      /* Conversions completed by the ADC0 interrupt 				*/
 
 	/*!
 	 * Infinite for:
@@ -97,9 +114,10 @@ int main(void)
 	 */
 	  for(;;)
 	  {
-		convertAdcChan(3);                   /* Convert Channel AD3 to pot on EVB 	*/
-		while(adc_complete()==0){}            /* Wait for conversion complete flag 	*/
-		adcResultInMv = read_adc_chx();       /* Get channel's conversion results in mv */
+		if (ADC_queue_pending()==0) {         /* Previous results delivered 	*/
+		  ADC_queue_request(3, ADC_result_ready);   /* Convert Channel AD3 to pot on EVB 	*/
+		  ADC_queue_request(29, ADC_result_ready);  /* Convert chan 29, Vrefsh 			*/
+		}
 
 		if (adcResultInMv > 3750) {           /* If result > 3.75V 		*/
 		  PTD->PCOR |= 1<<PTD15;			  /* turn off blue, green LEDs */
@@ -119,9 +137,10 @@ int main(void)
 		  PTD->PCOR |= 1<< PTD15 | 1<<PTD16; /* Turn off all LEDs */
 		  PTE->PCOR |= 1<<PTE8;
 		}
-
-		convertAdcChan(29);                   /* Convert chan 29, Vrefsh 			*/
-		while(adc_complete()==0){}            /* Wait for conversion complete flag */
-		adcResultInMv = read_adc_chx();       /* Get channel's conversion results in mv */
 	  }
 }
+
+void ADC0_IRQHandler(void)
+{
+  ADC_queue_IRQ();                      /* Deliver the result, start the next request */
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "device_registers.h"	/* include peripheral declarations */
+#include "FLASH.h"
+
+/*!
+* @brief Address of a flash location as seen by the FTFC commands:
+* D-Flash (FlexNVM) is selected with bit 23.
+*/
+static uint32_t FLASH_cmd_address (uint32_t address)
+{
+	if (address >= FEATURE_FLS_DF_START_ADDRESS)
+	{
+		address = (address - FEATURE_FLS_DF_START_ADDRESS) | 0x800000u;
+	}
+	return address;
+}
+
+/*!
+* @brief Launch the command loaded in FCCOB and wait for its completion.
+* Only D-Flash must be programmed or erased this way while the code runs
+* from P-Flash (read while write between blocks).
+*
+* @return 0 if the command completed, FSTAT error flags otherwise.
+*/
+static uint8_t FLASH_launch (void)
+{
+	FTFC -> FSTAT = FTFC_FSTAT_CCIF_MASK;								/* CCIF = 1 Launch the command */
+
+	while((FTFC -> FSTAT & FTFC_FSTAT_CCIF_MASK) == 0);					/* Wait for command completion */
+
+	return FTFC -> FSTAT & (FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK | FTFC_FSTAT_MGSTAT0_MASK);
+}
+
+/*!
+* @brief Load the command and the address in FCCOB0..3. FCCOB registers are
+* big-endian inside each word: FCCOB0 is FCCOB[3].
+*/
+static void FLASH_command (uint8_t command, uint32_t address)
+{
+	while((FTFC -> FSTAT & FTFC_FSTAT_CCIF_MASK) == 0);					/* Wait for a previous command */
+
+	FTFC -> FSTAT = FTFC_FSTAT_ACCERR_MASK | FTFC_FSTAT_FPVIOL_MASK;	/* Clear the errors of a previous command */
+
+	address = FLASH_cmd_address(address);
+	FTFC -> FCCOB[3] = command;											/* FCCOB0 Command */
+	FTFC -> FCCOB[2] = (uint8_t)(address >> 16);						/* FCCOB1 Address [23:16] */
+	FTFC -> FCCOB[1] = (uint8_t)(address >> 8);							/* FCCOB2 Address [15:8] */
+	FTFC -> FCCOB[0] = (uint8_t) address;								/* FCCOB3 Address [7:0] */
+}
+
+/*!
+* @brief Erase one sector.
+*
+* @param[uint32_t address] Address inside the sector, aligned to 8 bytes.
+*
+* @return 0 if the sector was erased.
+*/
+uint8_t FLASH_erase_sector (uint32_t address)
+{
+	FLASH_command(FLASH_CMD_ERASE_SECTOR, address);
+
+	return FLASH_launch();
+}
+
+/*!
+* @brief Program one phrase (8 bytes) of erased flash.
+*
+* @param[uint32_t address] Address aligned to 8 bytes.
+* @param[const uint32_t data[2]] Data, written in memory order.
+*
+* @return 0 if the phrase was programmed.
+*/
+uint8_t FLASH_program_phrase (uint32_t address, const uint32_t data[2])
+{
+	const uint8_t *bytes = (const uint8_t *) data;
+	uint8_t i;
+
+	FLASH_command(FLASH_CMD_PROGRAM_PHRASE, address);
+	for(i = 0; i < 8u; i++)
+	{
+		FTFC -> FCCOB[4u + i] = bytes[i];								/* FCCOB4..B Data, byte i at address + i */
+	}
+
+	return FLASH_launch();
+}
+
+/*!
+* @brief Checksum of a record, zero is never a valid checksum of an erased record.
+*/
+static uint32_t FLASH_record_checksum (const uint32_t *words, uint8_t count)
+{
+	uint32_t sum = count;
+
+	for(;count--;)
+	{
+		sum += *words++;
+	}
+	return ~sum;
+}
+
+/*!
+* @brief Save a record of words into a sector: the sector is erased, the
+* words are programmed, then a stamp phrase (magic and checksum) is
+* programmed last, so an interrupted write never leaves a valid record.
+*
+* @param[uint32_t address] Start of the sector.
+* @param[const uint32_t *words] Data of the record.
+* @param[uint8_t count] Amount of words.
+*
+* @return 0 if the record was saved.
+*/
+uint8_t FLASH_record_write (uint32_t address, const uint32_t *words, uint8_t count)
+{
+	uint32_t phrase[2];
+	uint8_t status;
+	uint8_t i;
+
+	status = FLASH_erase_sector(address);
+
+	for(i = 0; (i < count) && (status == 0u); i += 2u)
+	{
+		phrase[0] = words[i];
+		phrase[1] = ((i + 1u) < count) ? words[i + 1u] : 0xFFFFFFFFu;	/* Odd count: keep the last word erased */
+		status = FLASH_program_phrase(address + 4u * i, phrase);
+	}
+
+	if (status == 0u)
+	{
+		phrase[0] = FLASH_RECORD_MAGIC;
+		phrase[1] = FLASH_record_checksum(words, count);
+		status = FLASH_program_phrase(address + 4u * ((count + 1u) & ~1u), phrase);	/* Stamp */
+	}
+
+	return status;
+}
+
+/*!
+* @brief Read a record saved by FLASH_record_write.
+*
+* @param[uint32_t address] Start of the sector.
+* @param[uint32_t *words] Data of the record, only written if it is valid.
+* @param[uint8_t count] Amount of words.
+*
+* @return 1 if a valid record of count words was found.
+*/
+uint8_t FLASH_record_read (uint32_t address, uint32_t *words, uint8_t count)
+{
+	const uint32_t *record = (const uint32_t *) address;
+	const uint32_t *stamp = record + ((count + 1u) & ~1u);
+	uint8_t i;
+
+	if ((stamp[0] != FLASH_RECORD_MAGIC) || (stamp[1] != FLASH_record_checksum(record, count)))
+	{
+		return 0;
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		words[i] = record[i];
+	}
+	return 1;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#include "device_registers.h"
+
+#define FLASH_CMD_PROGRAM_PHRASE	0x07u	/* PGM8: program 8 bytes */
+#define FLASH_CMD_ERASE_SECTOR		0x09u	/* ERSSCR: erase one sector */
+#define FLASH_RECORD_MAGIC			0x5AFE0C4Bu	/* Validity stamp of a record */
+
+/* Last D-Flash (FlexNVM) sector, must not be used as EEPROM backup (FlexNVM not partitioned) */
+#define FLASH_DF_LAST_SECTOR	(FEATURE_FLS_DF_START_ADDRESS + FEATURE_FLS_DF_BLOCK_SIZE - FEATURE_FLS_DF_BLOCK_SECTOR_SIZE)
+
+uint8_t FLASH_erase_sector(uint32_t address);
+uint8_t FLASH_program_phrase(uint32_t address, const uint32_t data[2]);
+uint8_t FLASH_record_write(uint32_t address, const uint32_t *words, uint8_t count);
+uint8_t FLASH_record_read(uint32_t address, uint32_t *words, uint8_t count);
+
+#endif /* FLASH_H_ */
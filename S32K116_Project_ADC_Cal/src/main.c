@@ -51,14 +51,20 @@
  * the ADC readings will become imprecise.
  *
  * However, for this project and only to show the differences between ADC readings with different calibration parameters,
- * the calibration can be done several times because after each ADC reading the WDOG resets the MCU. 
+ * the calibration can be done several times: ADC_recalibrate aborts the conversions, clears the calibration
+ * registers and runs the calibration sequence again in place, without a reset of the MCU. Answer 'n' restores
+ * the calibration registers read after the reset to convert without calibration.
+ *
+ * Each calibration is saved in the last D-Flash sector with a validity stamp. After a reset,
+ * answer 's' to restore the stored values in a few register writes instead of running the
+ * calibration sequence again.
  * */
 
 #include "device_registers.h" 	/* include peripheral declarations S32K116 */
 #include "clocks_and_modes_S32K11x.h"
 #include "ADC.h"
 #include "LPUART_S32K11x.h"
-#include "WDOG.h"
+#include "FLASH.h"
 
 #define PTB0 (0)
 #define PTB1 (1)
@@ -68,6 +74,9 @@ uint16_t gain = 0;
 uint16_t offset = 0;
 uint32_t adc_mV_result = 0;
 uint8_t state = 0;
+ADC_Calibration_t calibration;		/* Calibration values saved in / restored from flash */
+uint8_t calibration_stored = 0;
+ADC_Calibration_t uncalibrated;		/* Calibration registers after reset */
 
 /*!
 * @brief PORTn Initialization
@@ -90,12 +99,6 @@ void PORT_init (void)
 	PORTB -> PCR[PTB1] |= PORT_PCR_MUX(2);   					/* Port B1: MUX = UART0 TX */
 }
 
-void Enable_Interrupt(uint8_t vector_number)
-{
-	S32_NVIC->ISER[(uint32_t)(vector_number) >> 5U] = (uint32_t)(1U << ((uint32_t)(vector_number) & (uint32_t)0x1FU));
-	S32_NVIC->ICPR[(uint32_t)(vector_number) >> 5U] = (uint32_t)(1U << ((uint32_t)(vector_number) & (uint32_t)0x1FU));
-}
-
 int main (void)
 {
 	/*!
@@ -123,6 +126,16 @@ int main (void)
 	LPUART0_transmit_string("	- There are negative and positive values. MSB determines the sign.\r\n");
 	LPUART0_transmit_string("	- Press ENTER to send the Gain and Offset value. \r\n\r\n");
 
+	ADC_init();								/* ADC initialization without calibration */
+	ADC_calibration_get(&uncalibrated);		/* Reset values, restored by the answer n */
+
+	/* Look for a calibration saved before the last reset */
+	calibration_stored = FLASH_record_read(FLASH_DF_LAST_SECTOR, (uint32_t *) &calibration, ADC_CALIBRATION_WORDS);
+	if (calibration_stored)
+	{
+		LPUART0_transmit_string("A calibration is stored in flash, answer s to restore it.\r\n");
+	}
+
 	/* Ask for initial calibration */
 	LPUART0_transmit_string("Would you like to calibrate the ADC module? y/n.\r\n\r\n");
 	LPUART0_transmit_string("> ");
@@ -156,7 +169,16 @@ int main (void)
 						if ((offset >= 0) && (offset <= 255))				/* Offset Value validation */
 						{
 							state = 0;
-							ADC_calibration_init(gain, offset);				/* Convert Channel AD3 to pot on EVB */
+							ADC_recalibrate(gain, offset);					/* Calibration without a reset of the MCU */
+							ADC_calibration_get(&calibration);				/* Keep the calibration for the next boots */
+							if (FLASH_record_write(FLASH_DF_LAST_SECTOR, (uint32_t *) &calibration, ADC_CALIBRATION_WORDS) != 0)
+							{
+								LPUART0_transmit_string("\r\nThe calibration could not be stored in flash.\r\n");
+							}
+							else
+							{
+								calibration_stored = 1;
+							}
 							ADC_channel_convert(3);                   		/* Convert Channel AD3 to pot on EVB */
 							while(ADC_conversion_complete() == 0){}         /* Wait for conversion complete flag */
 							adc_mV_result = ADC_channel_read();       		/* Get channel's conversion results in mV */
@@ -170,8 +192,8 @@ int main (void)
 							LPUART0_int_to_char(offset);					/* Convert data from int to char to be able to send by UART */
 							LPUART0_transmit_string("\r\n\r\n");
 
-							WDOG_init(); 									/* Reboot MCU to erase the ADC calibration register */
-							Enable_Interrupt(WDOG_IRQn);					/* Enable WDOG interrupt vector */
+							LPUART0_transmit_string("Would you like to calibrate the ADC module again? y/n.\r\n\r\n");
+							LPUART0_transmit_string("> ");
 						}
 						else
 						{
@@ -195,7 +217,7 @@ int main (void)
 		/* ADC module without calibration */
 		else if(answer == 'n')
 		{
-			ADC_init();											/* ADC initialization without calibration */
+			ADC_calibration_restore(&uncalibrated);				/* Calibration registers as after reset */
 			ADC_channel_convert(3);                   			/* Convert Channel AD3 to pot on EVB */
 			while(ADC_conversion_complete() == 0){}            	/* Wait for conversion complete flag */
 			adc_mV_result = ADC_channel_read();       			/* Get channel's conversion results in mV */
@@ -206,8 +228,30 @@ int main (void)
 			LPUART0_int_to_char(adc_mV_result);					/* Convert data from int to char to be able to send by UART */
 			LPUART0_transmit_string(" mV\r\n\r\n");
 
-			WDOG_init();										/* Reboot MCU to erase the ADC calibration register */
-			Enable_Interrupt(WDOG_IRQn);						/* Enable WDOG interrupt vector */
+			LPUART0_transmit_string("Would you like to calibrate the ADC module? y/n.\r\n\r\n");
+			LPUART0_transmit_string("> ");
+		}
+
+		/* ADC module with the calibration stored in flash */
+		else if((answer == 's') && calibration_stored)
+		{
+			ADC_calibration_restore(&calibration);				/* No calibration sequence */
+			ADC_channel_convert(3);                   			/* Convert Channel AD3 to pot on EVB */
+			while(ADC_conversion_complete() == 0){}            	/* Wait for conversion complete flag */
+			adc_mV_result = ADC_channel_read();       			/* Get channel's conversion results in mV */
+
+			/* Send ADC result by UART */
+			LPUART0_transmit_string("\r\n\r\n");
+			LPUART0_transmit_string("ADC result with the stored calibration is: ");
+			LPUART0_int_to_char(adc_mV_result);					/* Convert data from int to char to be able to send by UART */
+			LPUART0_transmit_string(" mV with UG = ");
+			LPUART0_int_to_char(calibration.ug);				/* Convert data from int to char to be able to send by UART */
+			LPUART0_transmit_string(" and USR_OFS = ");
+			LPUART0_int_to_char(calibration.usr_ofs);			/* Convert data from int to char to be able to send by UART */
+			LPUART0_transmit_string("\r\n\r\n");
+
+			LPUART0_transmit_string("Would you like to calibrate the ADC module? y/n.\r\n\r\n");
+			LPUART0_transmit_string("> ");
 		}
 
 		/* Incorrect answer. Input different of y/n */
@@ -222,12 +266,3 @@ int main (void)
 
 	return 0;
 }
-
-void WDOG_IRQHandler (void)
-{
-    /* WDOG interrupt flag active */
-	if((WDOG -> CS & WDOG_CS_FLG_MASK) == WDOG_CS_FLG_MASK)
-	{
-    	WDOG -> CS |= WDOG_CS_FLG_MASK;      							/* Clear the flag */
-    }
-}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*!
+ * Check and benchmark of the division-free mV conversion
+ * ===================================================
+ * ADC_raw_to_mV and ADC_Scale_batch replaced 5000 * raw / 0xFFF by a
+ * multiply with ADC_MV_FACTOR and a shift. Checked for every raw value of
+ * the 8, 10 and 12-bit modes and several references:
+ *  - against the truncating division it replaced: equal or 1 mV higher, as
+ *    the factor rounds to nearest;
+ *  - against the division rounded to nearest: at most 1 mV apart, for a
+ *    few results next to a .5 mV tie;
+ *  - ADC_Scale_batch with gain and offset against the same computed with
+ *    divisions, the clamp of negative results and the in-place conversion;
+ *  - the full scale limit of ADC_Scale_init (DEV_ASSERT).
+ * The benchmark converts a buffer with each method and reports ns/sample.
+ * On the host the division is a hardware instruction, so the ratio only
+ * bounds the gain on the M0+, where each sample of the old path calls the
+ * library division (__aeabi_uidiv, tens of cycles) instead of a MULS.
+ *
+ * Build and run on the host:
+ *   cc -O2 -DCPU_S32K116 '-DCUSTOM_DEVASSERT="adc_devassert.h"' '-DADC_NVIC_SYNC()=' \
+ *      -I. -I../include -I../src adc_scale_test.c ../src/ADC.c -o adc_scale_test && ./adc_scale_test
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "device_registers.h"
+#include "ADC.h"
+
+#define BENCH_SAMPLES	4096u
+#define BENCH_PASSES	2000u
+
+static const uint32_t Vref_mV[] = {1000, 1800, 3300, 5000};
+static const uint8_t Bits[] = {8, 10, 12};
+
+static uint32_t Raw[BENCH_SAMPLES];
+static uint32_t mV[BENCH_SAMPLES];
+static uint32_t volatile Full_scale = 0xFFFu;	/* Divisor unknown to the compiler, as the library call on the M0+ */
+static uint32_t failures;
+static uint32_t asserts;
+
+#define CHECK(cond, what)	check((cond) ? 1u : 0u, what, __LINE__)
+
+static void check(uint8_t ok, const char * what, int line)
+{
+	if (!ok) {
+		failures++;
+		printf("  FAIL line %d: %s\n", line, what);
+	}
+}
+
+void ADC_Test_assert(const char * expr, const char * file, int line)
+{
+	asserts++;
+	printf("  DEV_ASSERT(%s) failed at %s:%d\n", expr, file, line);
+}
+
+/* The conversion replaced by ADC_raw_to_mV */
+static void __attribute__ ((noinline)) div_batch(const uint32_t * raw, uint32_t * out, uint32_t count)
+{
+	while (count--) {
+		*out++ = (5000u * *raw++) / Full_scale;
+	}
+}
+
+static void __attribute__ ((noinline)) raw_to_mV_batch(const uint32_t * raw, uint32_t * out, uint32_t count)
+{
+	while (count--) {
+		*out++ = ADC_raw_to_mV((uint16_t) *raw++);
+	}
+}
+
+static void test_factor(void)
+{
+	uint32_t max;
+	uint32_t raw;
+	uint32_t factor;
+	uint32_t result;
+	uint32_t exact;
+	uint32_t ties;
+	uint8_t b;
+	uint8_t v;
+	uint8_t ok;
+
+	for (b = 0; b < sizeof(Bits); b++) {
+		max = (1u << Bits[b]) - 1u;
+		for (v = 0; v < sizeof(Vref_mV) / sizeof(Vref_mV[0]); v++) {
+			factor = ADC_MV_FACTOR(Vref_mV[v], Bits[b]);
+			ties = 0;
+			ok = 1;
+			CHECK(((uint64_t) max * factor + ADC_MV_ROUND) <= 0xFFFFFFFFu, "full scale fits 32 bits");
+			for (raw = 0; raw <= max; raw++) {
+				result = (raw * factor + ADC_MV_ROUND) >> ADC_MV_SHIFT;
+				exact = (2u * Vref_mV[v] * raw + max) / (2u * max);	/* Rounded division */
+				if ((result - (Vref_mV[v] * raw) / max) > 1u) {
+					ok = 0;		/* Truncating division: equal or 1 mV lower */
+				}
+				if (result != exact) {
+					ties++;
+					if ((result + 1u != exact) && (result != exact + 1u)) {
+						ok = 0;
+					}
+				}
+			}
+			printf("%2u bits, %4u mV: factor %7u, %2u result(s) 1 mV off the rounded division\n",
+				   Bits[b], (unsigned) Vref_mV[v], (unsigned) factor, (unsigned) ties);
+			CHECK(ok, "within 1 mV of the divisions");
+		}
+	}
+
+	ok = 1;
+	for (raw = 0; raw <= 0xFFFu; raw++) {
+		result = ADC_raw_to_mV((uint16_t) raw);
+		if ((result - (5000u * raw) / 0xFFFu) > 1u) {
+			ok = 0;
+		}
+	}
+	CHECK(ok, "ADC_raw_to_mV within 1 mV of 5000 * raw / 0xFFF");
+	CHECK(ADC_raw_to_mV(0xFFF) == 5000u, "full scale is 5000 mV");
+}
+
+static void test_scale_batch(void)
+{
+	static const uint32_t gain[] = {0x10000u, 0xF000u, 0x11000u, 0x2FFFFu};
+	static const int32_t offset[] = {0, -25, 40};
+	ADC_Scale_t scale;
+	uint64_t expected;
+	int64_t value;
+	uint32_t max;
+	uint32_t raw;
+	uint32_t errors = 0;
+	uint8_t b;
+	uint8_t g;
+	uint8_t o;
+
+	for (b = 0; b < sizeof(Bits); b++) {
+		max = (1u << Bits[b]) - 1u;
+		for (g = 0; g < sizeof(gain) / sizeof(gain[0]); g++) {
+			for (o = 0; o < sizeof(offset) / sizeof(offset[0]); o++) {
+				ADC_Scale_init(&scale, Bits[b], 5000, gain[g], offset[o]);
+				for (raw = 0; raw <= max; raw++) {
+					Raw[raw] = raw;
+				}
+				ADC_Scale_batch(&scale, Raw, mV, (uint16_t) (max + 1u));
+				for (raw = 0; raw <= max; raw++) {
+					expected = ((uint64_t) 5000u * raw * gain[g] * 2u + ((uint64_t) max << 16)) / ((uint64_t) max << 17);
+					value = (int64_t) expected + offset[o];
+					value = (value > 0) ? value : 0;
+					if ((mV[raw] + 1u < (uint64_t) value) || (mV[raw] > (uint64_t) value + 1u)) {
+						errors++;
+					}
+				}
+			}
+		}
+	}
+	printf("ADC_Scale_batch: %u result(s) more than 1 mV off\n", (unsigned) errors);
+	CHECK(errors == 0u, "ADC_Scale_batch with gain and offset");
+
+	ADC_Scale_init(&scale, 12, 5000, 0x10000u, -100);
+	CHECK(scale.factor == ADC_MV_FACTOR(5000, 12), "gain 1.0 keeps the factor");
+	Raw[0] = 0;
+	Raw[1] = 0xFFFu;
+	ADC_Scale_batch(&scale, Raw, Raw, 2);	/* In place */
+	CHECK(Raw[0] == 0u, "negative results clamped to 0");
+	CHECK(Raw[1] == 4900u, "in place conversion");
+
+	asserts = 0;
+	ADC_Scale_init(&scale, 12, 5000, 0x2FFFFu, 0);
+	CHECK(asserts == 0u, "gain just below 3.0 at 5000 mV accepted");
+	ADC_Scale_init(&scale, 12, 5500, 0x2FFFFu, 0);
+	CHECK(asserts == 1u, "5500 mV with gain 3.0 rejected (raw * factor overflows)");
+}
+
+static double bench(const char * name, void (*run)(void))
+{
+	clock_t start;
+	double ns;
+	uint32_t pass;
+
+	start = clock();
+	for (pass = 0; pass < BENCH_PASSES; pass++) {
+		run();
+	}
+	ns = (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ((double) BENCH_PASSES * BENCH_SAMPLES);
+	printf("  %-40s %6.2f ns/sample\n", name, ns);
+	return ns;
+}
+
+static ADC_Scale_t Bench_scale;
+
+static void run_div(void) { div_batch(Raw, mV, BENCH_SAMPLES); }
+static void run_raw_to_mV(void) { raw_to_mV_batch(Raw, mV, BENCH_SAMPLES); }
+static void run_scale_batch(void) { ADC_Scale_batch(&Bench_scale, Raw, mV, BENCH_SAMPLES); }
+
+static void benchmark(void)
+{
+	uint32_t i;
+	uint32_t seed = 1;
+	double div_ns;
+	double batch_ns;
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		seed = seed * 1103515245u + 12345u;
+		Raw[i] = (seed >> 16) & 0xFFFu;
+	}
+	ADC_Scale_init(&Bench_scale, 12, 5000, 0x10000u, 0);
+
+	printf("Benchmark, %u x %u samples\n", BENCH_PASSES, BENCH_SAMPLES);
+	div_ns = bench("5000 * raw / 0xFFF (replaced)", run_div);
+	bench("ADC_raw_to_mV", run_raw_to_mV);
+	batch_ns = bench("ADC_Scale_batch", run_scale_batch);
+	printf("  ADC_Scale_batch: %.1fx the speed of the division on this host\n", div_ns / batch_ns);
+}
+
+int main(void)
+{
+	test_factor();
+	test_scale_batch();
+	benchmark();
+
+	printf("%s: %u failure(s)\n", (failures == 0u) ? "PASS" : "FAIL", (unsigned) failures);
+	return (failures == 0u) ? 0 : 1;
+}
@@ -33,6 +33,27 @@
 #include "device_registers.h"           /* include peripheral declarations */
 #include "ADC.h"
 
+/* Complete a write to the NVIC before the next instruction runs: ICER takes effect
+ * only once the write has left the bus, so a pending ADC0 interrupt could still be
+ * taken inside the masked section without it. Host checks build it empty. */
+#ifndef ADC_NVIC_SYNC
+#define ADC_NVIC_SYNC()	__asm volatile ("dsb 0xF\n\tisb 0xF" : : : "memory")
+#endif
+
+/* Conversion request waiting in the ADC queue */
+typedef struct
+{
+	uint8_t 	   adc_channel;
+	ADC_callback_t callback;
+}ADC_request_t;
+
+static ADC_request_t ADC_queue[ADC_QUEUE_SIZE];
+static uint8_t volatile ADC_queue_head = 0;						/* Requests added, free running */
+static uint8_t volatile ADC_queue_tail = 0;						/* Requests converted, free running */
+static uint8_t ADC_Scan_count = 0;								/* Slots of the scan set by ADC_Scan_Config */
+static ADC_Monitor_callback_t ADC_Monitor_callback = 0;			/* Called on each limit crossing */
+static uint8_t volatile ADC_Monitor_alarm = 0;					/* 1 while the result meets the monitor mode */
+
 /*!
 * @brief ADC Initialization for SW trigger without calibration
 */
@@ -128,28 +149,172 @@ uint32_t ADC_channel_read (void)
 {
 	uint16_t adc_raw_result = 0;
 	adc_raw_result = ADC0 -> R[0];      						/* For SW trigger mode, R[0] is used */
-	return (uint32_t)((5000 * adc_raw_result) / 0xFFF); 		/* Convert result to mV for 0-5 V range */
+	return ADC_raw_to_mV(adc_raw_result); 						/* Convert result to mV for 0-5 V range */
 }
 
 /*!
-* @brief ADC Initialization for SW trigger with calibration
+* @brief Convert a 12-bit result to mV for 0-5 V range. The M0+ has no
+* divider, so the result is scaled by a constant factor and a shift.
+*
+* @param[uint16_t adc_raw_result] Result register value.
+*
+* @return[uint32_t] ADC result in mV.
+*/
+uint32_t ADC_raw_to_mV (uint16_t adc_raw_result)
+{
+	return ((uint32_t) adc_raw_result * ADC_MV_FACTOR(5000, 12) + ADC_MV_ROUND) >> ADC_MV_SHIFT;
+}
+
+/*!
+* @brief Compute the factor of ADC_Scale_batch. The divisions are done here,
+* once, so the conversion of each sample is a multiply and a shift.
+*
+* @param[ADC_Scale_t *scale] Scale to initialize.
+* @param[uint8_t bits] Resolution of the results: 8, 10 or 12 (CFG1[MODE]).
+* @param[uint32_t vref_mV] Full scale voltage in mV (e.g. 5000).
+* @param[uint32_t gain] Gain correction, 0x10000 = 1.0. vref_mV * gain must
+*        stay below 16383 mV (e.g. gain lower than 3.0 at 5000 mV) so that
+*        raw * factor fits in 32 bits at full scale.
+* @param[int32_t offset_mV] Offset correction in mV, added after the gain.
+*/
+void ADC_Scale_init (ADC_Scale_t *scale, uint8_t bits, uint32_t vref_mV, uint32_t gain, int32_t offset_mV)
+{
+	uint32_t factor = ADC_MV_FACTOR(vref_mV, bits);				/* mV per LSB with ADC_MV_SHIFT fraction bits */
+
+	scale->factor = (uint32_t)(((uint64_t) factor * gain + 0x8000u) >> 16);	/* Gain folded into the factor */
+	scale->offset = offset_mV;
+
+	DEV_ASSERT(scale->factor <= ((0xFFFFFFFFu - ADC_MV_ROUND) / ((1u << bits) - 1u)));	/* Full scale fits ADC_Scale_batch */
+}
+
+/*!
+* @brief Convert a buffer of raw results (e.g. filled by the DMA) to mV,
+* without divisions: mV = (raw * factor) >> ADC_MV_SHIFT + offset.
+* The conversion can be done in place (mV == raw).
+*
+* @param[const ADC_Scale_t *scale] Scale from ADC_Scale_init.
+* @param[const uint32_t volatile *raw] Raw results.
+* @param[uint32_t *mV] Results in mV, negative values are clamped to 0.
+* @param[uint16_t count] Amount of results.
+*/
+void ADC_Scale_batch (const ADC_Scale_t *scale, const uint32_t volatile *raw, uint32_t *mV, uint16_t count)
+{
+	uint32_t factor = scale->factor;
+	int32_t offset = scale->offset;
+	int32_t value;
+
+	for(;count--;)
+	{
+		value = (int32_t)((*raw++ * factor + ADC_MV_ROUND) >> ADC_MV_SHIFT) + offset;
+		*mV++ = (value > 0) ? (uint32_t) value : 0u;
+	}
+}
+
+/*!
+* @brief Start the conversion of the oldest request of the queue, with the
+* conversion complete interrupt enabled.
+*/
+static void ADC_queue_start (void)
+{
+	ADC0 -> SC1[0] = ADC_SC1_ADCH(ADC_queue[ADC_queue_tail & (ADC_QUEUE_SIZE - 1)].adc_channel)
+				   | ADC_SC1_AIEN_MASK;							/* AIEN = 1 COCO interrupt, conversion starts (SW trigger) */
+}
+
+/*!
+* @brief Initialize the conversion queue. The ADC must be initialized for SW
+* trigger first (ADC_init or ADC_calibration_init), ADC0_IRQHandler must
+* call ADC_queue_IRQ.
+*/
+void ADC_queue_init (void)
+{
+	ADC_queue_head = 0;
+	ADC_queue_tail = 0;
+
+	S32_NVIC -> ICPR[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* ADC0: clr any pending IRQ */
+	S32_NVIC -> ISER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* ADC0: enable IRQ */
+}
+
+/*!
+* @brief Add a conversion to the queue. The conversion starts at once if the
+* ADC is idle, otherwise when the previous requests are done. The function
+* does not wait: the callback gets the result from the ADC0 interrupt.
+*
+* @param[uint8_t adc_channel] ADC Channel.
+* @param[ADC_callback_t callback] Called with the channel and the raw result, can be 0.
+*
+* @return 1 if the request was queued, 0 if the queue is full.
+*/
+uint8_t ADC_queue_request (uint8_t adc_channel, ADC_callback_t callback)
+{
+	uint8_t queued = 0;
+
+	S32_NVIC -> ICER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* The ISR must not pop while a request is added */
+	ADC_NVIC_SYNC();												/* Masked before the queue is touched */
+
+	if ((uint8_t)(ADC_queue_head - ADC_queue_tail) < ADC_QUEUE_SIZE)
+	{
+		ADC_queue[ADC_queue_head & (ADC_QUEUE_SIZE - 1)].adc_channel = adc_channel;
+		ADC_queue[ADC_queue_head & (ADC_QUEUE_SIZE - 1)].callback = callback;
+		ADC_queue_head++;
+
+		if ((uint8_t)(ADC_queue_head - ADC_queue_tail) == 1u)
+		{
+			ADC_queue_start();									/* ADC was idle */
+		}
+		queued = 1;
+	}
+
+	S32_NVIC -> ISER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);
+
+	return queued;
+}
+
+/*!
+* @brief Number of requests in the queue, including the one being converted.
+*/
+uint8_t ADC_queue_pending (void)
+{
+	return (uint8_t)(ADC_queue_head - ADC_queue_tail);
+}
+
+/*!
+* @brief Conversion complete of a queued request, to be called from
+* ADC0_IRQHandler. The next request is started before the callback runs, so
+* the ADC converts while the result is processed. The callback may queue new
+* requests.
+*/
+void ADC_queue_IRQ (void)
+{
+	ADC_request_t request = ADC_queue[ADC_queue_tail & (ADC_QUEUE_SIZE - 1)];
+	uint16_t adc_raw_result = ADC0 -> R[0];						/* Reading R[0] clears COCO */
+
+	ADC_queue_tail++;
+	if (ADC_queue_head != ADC_queue_tail)
+	{
+		ADC_queue_start();
+	}
+
+	if (request.callback != 0)
+	{
+		request.callback(request.adc_channel, adc_raw_result);
+	}
+}
+
+/*!
+* @brief Clear the calibration registers and run the calibration sequence.
+* The ADC must be clocked and idle.
 *
 * @param[uint16_t gain] UG User Gain.
 * @param[uint16_t gain] USR_OFS User Offset.
 */
-void ADC_calibration_init (int16_t gain, int16_t offset)
+static void ADC_calibration_sequence (int16_t gain, int16_t offset)
 {
-	/* ADC0 Clocking */
-	PCC -> PCCn[PCC_ADC0_INDEX] &= ~PCC_PCCn_CGC_MASK;  		/* Disable clock to change PCS */
-	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_PCS(1);     		/* PCS = 1 Select SOSCDIV2 */
-	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_CGC_MASK;   		/* Enable bus clock in ADC */
-
 	/* ADC0 Calibration */
-	ADC0 -> CFG1 |= ADC_CFG1_ADIV(2) 							/* ADIV = 0 Prescaler = 1 */
-				 |  ADC_CFG1_MODE(1);							/* MODE = 1 12-bit conversion */
+	ADC0 -> CFG1 = ADC_CFG1_ADIV(2) 							/* ADIV = 2 Prescaler = 4 */
+				 | ADC_CFG1_MODE(1);							/* MODE = 1 12-bit conversion */
 																/* ADICLK = 0 Input CLK = ALTCLK1 = SOSCDIV2 */
 
-	ADC0 -> SC3 |= ADC_SC3_AVGE_MASK							/* AVGE = 1 Enable hardware average */
+	ADC0 -> SC3 = ADC_SC3_AVGE_MASK								/* AVGE = 1 Enable hardware average */
 	  			| ADC_SC3_AVGS(3);								/* AVGS = 11b 32 samples averaged */
 
 	/* Initialization for the Internal ADC0 Calibration Registers */
@@ -166,6 +331,22 @@ void ADC_calibration_init (int16_t gain, int16_t offset)
 	ADC0 -> SC3 |= ADC_SC3_CAL_MASK;							/* CAL = 1 Start calibration sequence */
 
 	while(ADC_conversion_complete() == 0);          			/* Wait for conversion complete flag */
+}
+
+/*!
+* @brief ADC Initialization for SW trigger with calibration
+*
+* @param[uint16_t gain] UG User Gain.
+* @param[uint16_t gain] USR_OFS User Offset.
+*/
+void ADC_calibration_init (int16_t gain, int16_t offset)
+{
+	/* ADC0 Clocking */
+	PCC -> PCCn[PCC_ADC0_INDEX] &= ~PCC_PCCn_CGC_MASK;  		/* Disable clock to change PCS */
+	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_PCS(1);     		/* PCS = 1 Select SOSCDIV2 */
+	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_CGC_MASK;   		/* Enable bus clock in ADC */
+
+	ADC_calibration_sequence(gain, offset);
 
 	/* ADC0 Initialization */
 	ADC0 -> SC1[0] |= ADC_SC1_ADCH_MASK; 						/* ADCH = 1F Module is disabled for conversions */
@@ -188,6 +369,97 @@ void ADC_calibration_init (int16_t gain, int16_t offset)
                                   	  	  	  	  	  	  	  	/* AVGE, AVGS = 0 HW average function disabled */
 }
 
+/*!
+* @brief Run the calibration sequence again without a reset of the MCU.
+* The conversion in progress is aborted, the calibration registers are
+* cleared and, once calibrated, the configuration (CFG1, CFG2, SC2, SC3) is
+* put back. A HW triggered channel of SC1[0] is armed again and an aborted
+* request of the conversion queue is converted again.
+*
+* @param[uint16_t gain] UG User Gain.
+* @param[uint16_t gain] USR_OFS User Offset.
+*/
+void ADC_recalibrate (int16_t gain, int16_t offset)
+{
+	uint32_t sc1  = ADC0 -> SC1[0];
+	uint32_t cfg1 = ADC0 -> CFG1;
+	uint32_t cfg2 = ADC0 -> CFG2;
+	uint32_t sc2  = ADC0 -> SC2;
+	uint32_t sc3  = ADC0 -> SC3;
+	uint32_t irq_enabled = S32_NVIC -> ISER[ADC0_IRQn >> 5] & (1u << (ADC0_IRQn & 0x1Fu));
+
+	S32_NVIC -> ICER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* No queue ISR during the calibration */
+
+	/* Quiesce ADC0 */
+	ADC0 -> SC2 = 0x00000000;									/* ADTRG = 0 No HW trigger, DMAEN = 0, compare disabled */
+	ADC0 -> SC1[0] = ADC_SC1_ADCH_MASK;							/* ADCH = 1F Abort conversion, AIEN = 0 */
+	while((ADC0 -> SC2 & ADC_SC2_ADACT_MASK) != 0);				/* Wait until no conversion is active */
+
+	ADC_calibration_sequence(gain, offset);
+	(void) ADC0 -> R[0];										/* Reading R[0] clears the COCO of the calibration */
+
+	/* Resume */
+	ADC0 -> CFG1 = cfg1;
+	ADC0 -> CFG2 = cfg2;
+	ADC0 -> SC3  = sc3 & ~ADC_SC3_CAL_MASK;
+	ADC0 -> SC2  = sc2;
+
+	if ((sc2 & ADC_SC2_ADTRG_MASK) != 0)
+	{
+		ADC0 -> SC1[0] = sc1 & ~ADC_SC1_COCO_MASK;				/* HW trigger: channel armed for the next trigger */
+	}
+	else if (ADC_queue_head != ADC_queue_tail)
+	{
+		ADC_queue_start();										/* Aborted request converted again */
+	}
+
+	S32_NVIC -> ICPR[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* Drop the IRQ of the aborted conversion */
+	if (irq_enabled != 0)
+	{
+		S32_NVIC -> ISER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);
+	}
+}
+
+/*!
+* @brief Read the calibration values left by the calibration sequence
+* (ADC_calibration_init), e.g. to keep them in flash.
+*
+* @param[ADC_Calibration_t *cal] Calibration values.
+*/
+void ADC_calibration_get (ADC_Calibration_t *cal)
+{
+	cal -> clps    = ADC0 -> CLPS;
+	cal -> clp3    = ADC0 -> CLP3;
+	cal -> clp2    = ADC0 -> CLP2;
+	cal -> clp1    = ADC0 -> CLP1;
+	cal -> clp0    = ADC0 -> CLP0;
+	cal -> clpx    = ADC0 -> CLPX;
+	cal -> clp9    = ADC0 -> CLP9;
+	cal -> usr_ofs = ADC0 -> USR_OFS;
+	cal -> ug      = ADC0 -> UG;
+}
+
+/*!
+* @brief ADC Initialization for SW trigger with calibration values saved
+* before (ADC_calibration_get), instead of the calibration sequence.
+*
+* @param[const ADC_Calibration_t *cal] Calibration values.
+*/
+void ADC_calibration_restore (const ADC_Calibration_t *cal)
+{
+	ADC_init();													/* Same configuration as after ADC_calibration_init */
+
+	ADC0 -> CLPS    = cal -> clps;
+	ADC0 -> CLP3    = cal -> clp3;
+	ADC0 -> CLP2    = cal -> clp2;
+	ADC0 -> CLP1    = cal -> clp1;
+	ADC0 -> CLP0    = cal -> clp0;
+	ADC0 -> CLPX    = cal -> clpx;
+	ADC0 -> CLP9    = cal -> clp9;
+	ADC0 -> USR_OFS = cal -> usr_ofs;
+	ADC0 -> UG      = cal -> ug;
+}
+
 /*! Configuration of 4 channels from the ADC0, those channels are
  * 	trigger from the PDB, the results are saved with the DMA.
  * 		ADC0->SC1[4] Pot
@@ -218,6 +490,266 @@ void ADC_Config(uint8_t Pot_Ch){
 	ADC0->SC3 = 0x00000000; 			/* Disable any configuration enabled of the calibration */
 }
 
+/*! Configuration of a scan list of up to ADC_SC1_COUNT channels, one per
+ * 	SC1[n] slot starting at SC1[0], triggered by the PDB pre-triggers
+ * 	(PDB_Scan_Config with the same count). Slot n is converted into R[n].
+ *
+ * 		@param [const uint8_t *channels] ADCH of each slot.
+ * 		@param [uint8_t count] Number of slots, 1 to ADC_SC1_COUNT. 0 is ignored,
+ * 			larger values are cut to ADC_SC1_COUNT.
+ * 		@param [uint8_t dma] 1: a DMA request is generated for each COCO.
+ */
+void ADC_Scan_Config(const uint8_t *channels, uint8_t count, uint8_t dma){
+	uint8_t slot;
+
+	DEV_ASSERT((count > 0u) && (count <= ADC_SC1_COUNT));
+	if (count == 0u)
+	{
+		return;							/* Nothing to scan: the ADC is left as it is */
+	}
+	if (count > ADC_SC1_COUNT)
+	{
+		count = ADC_SC1_COUNT;			/* DEV_ASSERT is empty in release builds: never write past SC1[15] (CFG1) */
+	}
+	ADC_Scan_count = count;
+
+	for(slot = 0; slot < ADC_SC1_COUNT; slot++)
+	{
+		ADC0->SC1[slot] = ADC_SC1_ADCH_MASK;	/* All slots disabled while configuring */
+	}
+
+	ADC0->CFG1 = ADC_CFG1_ADIV(0)|	/* Divide ratio = 1 */
+				 ADC_CFG1_MODE(1);	/*	12-bit conversion */
+
+	ADC0->CFG2 = ADC_CFG2_SMPLTS(12);	/* sample time is 13 ADC clks */
+
+	ADC0->SC2 = ADC_SC2_ADTRG(1)|			/* ADTRG = 1: HW trigger */
+				ADC_SC2_DMAEN(dma ? 1 : 0);	/* DMA request on COCO */
+
+	for(slot = 0; slot < count; slot++)
+	{
+		ADC0->SC1[slot] = ADC_SC1_ADCH(channels[slot]);	/* Channel of the slot, converted on its pre-trigger */
+	}
+	ADC0->SC3 = 0x00000000; 			/* Disable any configuration enabled of the calibration */
+}
+
+/*!
+* @brief Check the conversion complete flag [COCO] of the last slot of the scan.
+*
+* @return 1 when the whole scan is converted, 0 also when no scan is configured.
+*/
+uint8_t ADC_Scan_complete (void)
+{
+	if (ADC_Scan_count == 0u)
+	{
+		return 0;										/* ADC_Scan_Config not called yet */
+	}
+	return ((ADC0 -> SC1[ADC_Scan_count - 1] & ADC_SC1_COCO_MASK) >> ADC_SC1_COCO_SHIFT);
+}
+
+/*!
+* @brief Read the raw results of all the slots of the scan, this clears their COCO flags.
+*
+* @param[uint16_t *results] One result per slot, in the order of the scan list.
+*/
+void ADC_Scan_read (uint16_t *results)
+{
+	uint8_t slot;
+
+	for(slot = 0; slot < ADC_Scan_count; slot++)
+	{
+		results[slot] = (uint16_t) ADC0 -> R[slot];
+	}
+}
+
+/*! Configuration of a threshold monitor on SC1[0], triggered by the PDB
+ * 	(PDB_Scan_Config with a count of 1). The compare function discards the
+ * 	results that do not meet the mode, so COCO and the ADC0 interrupt only
+ * 	happen on an event: ADC_Monitor_IRQ then inverts the condition (ACFGT),
+ * 	so the next interrupt is the return across the limit. The compare
+ * 	function applies to every slot of ADC0, a DMA scan running at the same
+ * 	time only gets the results that meet the mode as well.
+ *
+ * 		@param [uint8_t adc_channel] ADCH of the supervised input.
+ * 		@param [ADC_Monitor_mode_t mode] Condition that raises the alarm.
+ * 		@param [uint16_t low] CV1, the limit of ADC_MONITOR_BELOW / ABOVE.
+ * 		@param [uint16_t high] CV2, upper limit of ADC_MONITOR_OUTSIDE / INSIDE (low <= high).
+ * 		@param [ADC_Monitor_callback_t callback] Called from ADC_Monitor_IRQ, can be 0.
+ */
+void ADC_Monitor_Config(uint8_t adc_channel, ADC_Monitor_mode_t mode, uint16_t low, uint16_t high, ADC_Monitor_callback_t callback){
+	PCC -> PCCn[PCC_ADC0_INDEX] &= ~PCC_PCCn_CGC_MASK;  		/* Disable clock to change PCS */
+	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_PCS(1);     		/* PCS = 1 Select SOSCDIV2 */
+	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_CGC_MASK;   		/* Enable bus clock in ADC */
+
+	ADC_Monitor_callback = callback;
+	ADC_Monitor_alarm = 0;
+
+	ADC0 -> SC1[0] = ADC_SC1_ADCH_MASK;							/* ADCH = 1F Module is disabled for conversions */
+
+	ADC0 -> CFG1 = ADC_CFG1_ADIV(0)								/* ADIV = 0 Prescaler = 1 */
+                 | ADC_CFG1_MODE(1); 							/* MODE = 1 12-bit conversion */
+
+	ADC0 -> CFG2 = ADC_CFG2_SMPLTS(12);							/* SMPLTS = 12(default): sample time is 13 ADC clks */
+
+	ADC0 -> CV[0] = ADC_CV_CV(low);								/* CV1 */
+	ADC0 -> CV[1] = ADC_CV_CV(high);							/* CV2 */
+
+	ADC0 -> SC2 = ADC_SC2_ADTRG(1)								/* ADTRG = 1 HW trigger */
+				| ADC_SC2_ACFE_MASK								/* ACFE = 1 Compare function enabled */
+				| (uint32_t) mode;								/* ACFGT, ACREN of the mode */
+
+	ADC0 -> SC3 = 0x00000000;									/* ADCO = 0, AVGE = 0 */
+
+	ADC0 -> SC1[0] = ADC_SC1_ADCH(adc_channel)
+				   | ADC_SC1_AIEN_MASK;							/* AIEN = 1 Interrupt on each event */
+
+	S32_NVIC -> ICPR[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* ADC0: clr any pending IRQ */
+	S32_NVIC -> ISER[ADC0_IRQn >> 5] = 1u << (ADC0_IRQn & 0x1Fu);	/* ADC0: enable IRQ */
+}
+
+/*!
+* @brief Limit crossing of the monitor, to be called from ADC0_IRQHandler.
+* The compare condition is inverted, so the monitor now waits for the
+* opposite crossing.
+*/
+void ADC_Monitor_IRQ (void)
+{
+	uint16_t adc_raw_result = ADC0 -> R[0];						/* Reading R[0] clears COCO */
+
+	ADC0 -> SC2 ^= ADC_SC2_ACFGT_MASK;							/* Complement of the condition */
+	ADC_Monitor_alarm ^= 1u;
+
+	if (ADC_Monitor_callback != 0)
+	{
+		ADC_Monitor_callback(adc_raw_result, ADC_Monitor_alarm);
+	}
+}
+
+/*!
+* @brief State of the monitor.
+*
+* @return 1 while the input meets the mode of ADC_Monitor_Config.
+*/
+uint8_t ADC_Monitor_state (void)
+{
+	return ADC_Monitor_alarm;
+}
+
+/*!
+* @brief Derive CFG1 ADIV / MODE, CFG2 SMPLTS and SC3 AVGE / AVGS from the
+* needs of the channel instead of fixed values. Call it after the ADC
+* configuration, before the conversions are triggered.
+* 	- ADIV: the fastest ADCK up to ADC_ADCK_MAX_HZ, slower only when the sample
+* 	  time does not fit in SMPLTS.
+* 	- SMPLTS: time for the sampling capacitor to settle to 1/4 LSB through the
+* 	  source impedance, t = (R_source + ADC_RADIN_OHM) * ADC_CSAMPLE_PF * (bits + 2) * ln 2.
+* 	- AVGS: the largest hardware average that still meets the sample rate, so
+* 	  slow channels get averaged results instead of unused conversions.
+*
+* @param[uint32_t source_hz] Frequency of the ADC0 clock selected in the PCC (ALTCLK1).
+* @param[uint32_t rate] Results per second needed.
+* @param[uint8_t bits] Resolution: 8, 10 or 12.
+* @param[uint32_t impedance_ohm] Source impedance of the channel.
+*
+* @return[uint32_t] Achieved time per result in ns, averaging included. Above
+* 1e9 / rate when the rate cannot be met.
+*/
+uint32_t ADC_Timing_config (uint32_t source_hz, uint32_t rate, uint8_t bits, uint32_t impedance_ohm)
+{
+	uint8_t adiv = 0;
+	uint8_t avgs;
+	uint32_t mode;
+	uint32_t adck_khz;
+	uint32_t settle_ns;
+	uint32_t sample_clks;
+	uint32_t conversion_ns;
+	uint32_t period_ns = 1000000000u / ((rate > 0u) ? rate : 1u);
+
+	switch (bits)
+	{
+		case 8:  mode = 0; break;								/* MODE = 0 8-bit conversion */
+		case 10: mode = 2; break;								/* MODE = 2 10-bit conversion */
+		default: mode = 1; bits = 12; break;					/* MODE = 1 12-bit conversion */
+	}
+
+	/* Settling time, (R / 100) * C in 0.1 ns units to stay in 32 bits */
+	settle_ns = ((impedance_ohm + ADC_RADIN_OHM) / 100u) * ADC_CSAMPLE_PF * (bits + 2u) * 693u / 10000u;
+
+	while ((adiv < 3u) && ((source_hz >> adiv) > ADC_ADCK_MAX_HZ))
+	{
+		adiv++;													/* ADCK within the maximum */
+	}
+	for (;;)
+	{
+		adck_khz = (source_hz >> adiv) / 1000u;
+		sample_clks = (uint32_t)(((uint64_t) settle_ns * adck_khz + 999999u) / 1000000u);
+		if ((sample_clks <= ADC_SAMPLE_CLKS_MAX) || (adiv == 3u))
+		{
+			break;
+		}
+		adiv++;													/* Too long for SMPLTS, slower ADCK */
+	}
+	if (sample_clks < ADC_SAMPLE_CLKS_MIN)
+	{
+		sample_clks = ADC_SAMPLE_CLKS_MIN;
+	}
+	if (sample_clks > ADC_SAMPLE_CLKS_MAX)
+	{
+		sample_clks = ADC_SAMPLE_CLKS_MAX;						/* Source too slow, not fully settled */
+	}
+
+	conversion_ns = (sample_clks + ADC_CONVERT_CLKS(bits)) * 1000000u / adck_khz;
+
+	/* Largest average (4 << AVGS results) that fits in the period */
+	for (avgs = 4; avgs > 0; avgs--)
+	{
+		if (((4u << (avgs - 1u)) * conversion_ns) <= period_ns)
+		{
+			break;
+		}
+	}
+
+	ADC0 -> CFG1 = (ADC0 -> CFG1 & ~(ADC_CFG1_ADIV_MASK | ADC_CFG1_MODE_MASK | ADC_CFG1_ADICLK_MASK))
+				 | ADC_CFG1_ADIV(adiv)							/* ADCK = source / 2^ADIV */
+				 | ADC_CFG1_MODE(mode);							/* ADICLK = 0 Input CLK = ALTCLK1 */
+
+	ADC0 -> CFG2 = ADC_CFG2_SMPLTS(sample_clks - 1u);			/* Sample time is SMPLTS + 1 ADC clks */
+
+	ADC0 -> SC3 &= ~(ADC_SC3_CAL_MASK | ADC_SC3_AVGE_MASK | ADC_SC3_AVGS_MASK);
+	if (avgs > 0)
+	{
+		ADC0 -> SC3 |= ADC_SC3_AVGE_MASK						/* AVGE = 1 Enable hardware average */
+					|  ADC_SC3_AVGS(avgs - 1u);					/* 4, 8, 16 or 32 samples averaged */
+		conversion_ns *= 4u << (avgs - 1u);
+	}
+
+	return conversion_ns;
+}
+
+/*!
+ * ADC Configuration for a DMA driven sequence (DMA_Sequence_Config): SW trigger,
+ * so each write of SC1A by the DMA starts a conversion, and a DMA request
+ * when COCO is set.
+ */
+void ADC_Sequence_Config(void){
+	PCC -> PCCn[PCC_ADC0_INDEX] &= ~PCC_PCCn_CGC_MASK;  		/* Disable clock to change PCS */
+	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_PCS(1);     		/* PCS = 1 Select SOSCDIV2 */
+	PCC -> PCCn[PCC_ADC0_INDEX] |= PCC_PCCn_CGC_MASK;   		/* Enable bus clock in ADC */
+
+	ADC0 -> SC1[0] = ADC_SC1_ADCH_MASK;							/* ADCH = 1F Module is disabled for conversions */
+
+	ADC0 -> CFG1 = ADC_CFG1_ADIV(0)								/* ADIV = 0 Prescaler = 1 */
+                 | ADC_CFG1_MODE(1); 							/* MODE = 1 12-bit conversion */
+																/* ADICLK = 0 Input CLK = ALTCLK1 = SOSCDIV2 */
+
+	ADC0 -> CFG2 = ADC_CFG2_SMPLTS(12);							/* SMPLTS = 12(default): sample time is 13 ADC clks */
+
+	ADC0 -> SC2 = ADC_SC2_DMAEN_MASK;							/* ADTRG = 0 SW trigger */
+																/* DMAEN = 1 DMA request on COCO */
+
+	ADC0 -> SC3 = 0x00000000;         							/* ADCO = 0 One conversion per SC1A write */
+}
+
 /*!
  * ADC Configuration to work using HW Trigger (PDB) and to generate a DMA request
  * when COCO is set.
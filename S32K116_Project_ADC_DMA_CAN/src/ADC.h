@@ -33,6 +33,59 @@
 #ifndef ADC_H_
 #define ADC_H_
 
+#define ADC_QUEUE_SIZE	8		/* Requests of the conversion queue, power of 2 */
+
+/* Result to mV without divisions: mV = (raw * factor + ADC_MV_ROUND) >> ADC_MV_SHIFT */
+#define ADC_MV_SHIFT	18		/* Fraction bits of the factor, raw * factor fits in 32 bits up to 12-bit results */
+#define ADC_MV_ROUND	(1u << (ADC_MV_SHIFT - 1))
+#define ADC_MV_FACTOR(vref_mV, bits)	((((uint32_t)(vref_mV) << ADC_MV_SHIFT) + ((1u << (bits)) - 1u) / 2u) / ((1u << (bits)) - 1u))
+
+/* Limits and analog model used by ADC_Timing_config */
+#define ADC_ADCK_MAX_HZ		50000000u	/* Maximum ADC conversion clock */
+#define ADC_SAMPLE_CLKS_MIN	2u			/* Shortest sample time, SMPLTS = 1 */
+#define ADC_SAMPLE_CLKS_MAX	256u		/* Longest sample time, SMPLTS = 255 */
+#define ADC_CSAMPLE_PF		5u			/* Sampling capacitor */
+#define ADC_RADIN_OHM		1000u		/* Input switch resistance in series with the source */
+#define ADC_CONVERT_CLKS(bits)	(2u * (bits) + 5u)	/* Conversion phase after the sample time, ADCK clocks */
+
+/* Conversion of raw results to mV with gain and offset correction */
+typedef struct
+{
+	uint32_t factor;	/* mV per LSB with ADC_MV_SHIFT fraction bits, gain included */
+	int32_t  offset;	/* mV added after the scaling */
+}ADC_Scale_t;
+
+/* Result of the calibration sequence, restored in a few register writes */
+typedef struct
+{
+	uint32_t clps;
+	uint32_t clp3;
+	uint32_t clp2;
+	uint32_t clp1;
+	uint32_t clp0;
+	uint32_t clpx;
+	uint32_t clp9;
+	uint32_t usr_ofs;		/* User offset used during the calibration */
+	uint32_t ug;			/* User gain used during the calibration */
+}ADC_Calibration_t;
+
+#define ADC_CALIBRATION_WORDS	(sizeof(ADC_Calibration_t) / sizeof(uint32_t))
+
+/* Result of a queued conversion, called from the ADC0 interrupt */
+typedef void (*ADC_callback_t)(uint8_t adc_channel, uint16_t adc_raw_result);
+
+/* Condition of the threshold monitor, as SC2 ACREN / ACFGT bits (CV1 <= CV2) */
+typedef enum
+{
+	ADC_MONITOR_BELOW   = 0,										/* result < CV1 */
+	ADC_MONITOR_ABOVE   = ADC_SC2_ACFGT_MASK,						/* result >= CV1 */
+	ADC_MONITOR_OUTSIDE = ADC_SC2_ACREN_MASK,						/* result < CV1 or result > CV2 */
+	ADC_MONITOR_INSIDE  = ADC_SC2_ACREN_MASK | ADC_SC2_ACFGT_MASK	/* CV1 <= result <= CV2 */
+}ADC_Monitor_mode_t;
+
+/* Limit crossing of the monitor: alarm = 1 when the mode is met, 0 when it is left */
+typedef void (*ADC_Monitor_callback_t)(uint16_t adc_raw_result, uint8_t alarm);
+
 /* Public Function Prototypes*/
 
 void 	 ADC_channel_convert		(uint16_t adc_channel);
@@ -40,8 +93,26 @@ void 	 ADC_init					(void);
 void 	 ADC_HW_trigger_init		(int8_t adc_channel);
 uint8_t  ADC_conversion_complete	(void);
 uint32_t ADC_channel_read			(void);
+uint32_t ADC_raw_to_mV				(uint16_t adc_raw_result);
+void 	 ADC_Scale_init				(ADC_Scale_t *scale, uint8_t bits, uint32_t vref_mV, uint32_t gain, int32_t offset_mV);
+void 	 ADC_Scale_batch			(const ADC_Scale_t *scale, const uint32_t volatile *raw, uint32_t *mV, uint16_t count);
 void 	 ADC_calibration_init		(int16_t gain, int16_t offset);
+void 	 ADC_recalibrate			(int16_t gain, int16_t offset);
+void 	 ADC_calibration_get		(ADC_Calibration_t *cal);
+void 	 ADC_calibration_restore	(const ADC_Calibration_t *cal);
 void	 ADC_Config					(uint8_t Pot_Ch);
 void 	 ADC_FlexScan_Config		(void);
+void	 ADC_Scan_Config			(const uint8_t *channels, uint8_t count, uint8_t dma);
+uint8_t  ADC_Scan_complete			(void);
+void 	 ADC_Sequence_Config		(void);
+void	 ADC_Monitor_Config			(uint8_t adc_channel, ADC_Monitor_mode_t mode, uint16_t low, uint16_t high, ADC_Monitor_callback_t callback);
+void 	 ADC_Monitor_IRQ			(void);
+uint8_t  ADC_Monitor_state			(void);
+uint32_t ADC_Timing_config			(uint32_t source_hz, uint32_t rate, uint8_t bits, uint32_t impedance_ohm);
+void 	 ADC_Scan_read				(uint16_t *results);
+void 	 ADC_queue_init				(void);
+uint8_t  ADC_queue_request			(uint8_t adc_channel, ADC_callback_t callback);
+uint8_t  ADC_queue_pending			(void);
+void 	 ADC_queue_IRQ				(void);
 
 #endif /* ADC_H_ */
@@ -40,6 +40,22 @@ uint32_t volatile ADC_SC1A_CH[3] = {30,29,3}; /*< Array to set up the external c
 											/*< 8 -> PTB13, 9-> PTB14, 12-> Potentiometer			*/
 uint32_t volatile ADC_Results[16];			/*< Destination of the results of each ADC sample made */
 
+#define ADC_SC1A_CH_COUNT	(sizeof(ADC_SC1A_CH) / sizeof(ADC_SC1A_CH[0]))	/*< Channels of one FlexScan scan */
+
+/* TCD0 image: 11 bytes from TCD0_Source to TCD0_Dest, channel disabled at the end */
+DMA_TCD_DEFINE(TCD_init_image,
+			   &TCD0_Source[0],			/* Source Address. */
+			   1,						/* Src. addr add 1 byte after Transfers */
+			   &TCD0_Dest,				/* Destination Address. */
+			   0,						/* No dest adr offset after transfer */
+			   0, 0,					/* Src./Dest. 2**0 =1 byte per transfer, no modulo */
+			   1,						/* Transfer 1 byte /minor loop */
+			   -11,						/* Src addr change after major loop */
+			   0,						/* No dest chg after major loop */
+			   11,						/* 11 minor loop iterations */
+			   DMA_TCD_NO_LINK,			/* No minor loop chan link */
+			   DMA_TCD_CSR_DREQ(1));	/* Disable chan after major loop, no IRQ, no link */
+
 void DMA_init(void)
 {
  /* This is an initialization place holder for:   											*/
@@ -47,6 +63,137 @@ void DMA_init(void)
  /* 2. Enabling desired channels by setting ERQ bit (not needed when START bit used) 		*/
 }
 
+static DMA_Channel_entry_t DMA_Channels[DMA_TCD_COUNT];	/*< Channel allocation table */
+
+/*!
+ * Channel priority
+ * ===================================================
+ * Give one channel a priority level of its class. Each class has its own
+ * band of DCHPRI levels (DMA_PRIO_BAND), so bulk channels always rank below
+ * normal ones and normal ones below critical ones, and the level is one that
+ * no other channel holds. Only the DCHPRI of this channel is written: the
+ * levels of the channels already running are left untouched, so the
+ * priorities stay unique at every moment (a request served while two
+ * channels share a level raises ES[CPE]) and channels can be allocated and
+ * freed while others are active. Bulk channels can be preempted (ECP = 1)
+ * and cannot preempt (DPA = 1), critical channels can preempt them.
+ *
+ * @param[uint8_t ch] DMA channel
+ * @param[DMA_Priority_t priority] Priority class of the channel
+ *
+ */
+static void DMA_Channel_priority(uint8_t ch, DMA_Priority_t priority)
+{
+	uint8_t level;
+	uint8_t other;
+	uint8_t taken;
+	uint8_t preemption;
+
+	for (level = (uint8_t)(priority * DMA_PRIO_BAND); level < (uint8_t)((priority + 1u) * DMA_PRIO_BAND); level++) {
+		taken = 0;
+		for (other = 0; other < DMA_TCD_COUNT; other++) {
+			if ((other != ch) &&
+				((DMA->DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(other)] & DMA_DCHPRI_CHPRI_MASK) == level)) {
+				taken = 1;
+			}
+		}
+		if (taken == 0u) {
+			break;	/* One of the DMA_PRIO_BAND levels is always free: only DMA_TCD_COUNT - 1 other channels */
+		}
+	}
+
+	switch (priority) {
+	case DMA_PRIO_BULK:
+		preemption = DMA_DCHPRI_ECP(1) | DMA_DCHPRI_DPA(1);	/* Can be suspended, cannot suspend */
+		break;
+	case DMA_PRIO_CRITICAL:
+		preemption = DMA_DCHPRI_ECP(0) | DMA_DCHPRI_DPA(0);	/* Cannot be suspended, can suspend */
+		break;
+	default:
+		preemption = DMA_DCHPRI_ECP(0) | DMA_DCHPRI_DPA(1);	/* No preemption */
+		break;
+	}
+
+	DMA->DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)] = DMA_DCHPRI_CHPRI(level) | preemption;
+}
+
+/*!
+ * Reserve a DMA channel
+ * ===================================================
+ * Mark a fixed channel as used, route its request source through the DMAMUX
+ * and give it a priority level of its class (the other channels keep theirs).
+ *
+ * @param[uint8_t ch] DMA channel
+ * @param[dma_request_source_t source] Request source (EDMA_REQ_DISABLED when only started by links or software)
+ * @param[DMA_Priority_t priority] Priority class of the channel
+ *
+ */
+void DMA_Channel_reserve(uint8_t ch, dma_request_source_t source, DMA_Priority_t priority)
+{
+	DEV_ASSERT(ch < DMA_TCD_COUNT);
+
+	SIM->PLATCGC |= SIM_PLATCGC_CGCDMA_MASK;			/* DMA Clock Gating Control Enable */
+	PCC->PCCn[PCC_DMAMUX_INDEX] |= PCC_PCCn_CGC_MASK;	/* Enable clock for DMAMUX */
+
+	DMA_Channels[ch].used     = 1;
+	DMA_Channels[ch].priority = priority;
+	DMA_Channels[ch].source   = source;
+
+	DMAMUX->CHCFG[ch] = 0;		/* Disable the channel before changing its source */
+	if (source != EDMA_REQ_DISABLED) {
+		DMAMUX->CHCFG[ch] = DMAMUX_CHCFG_SOURCE(source) | DMAMUX_CHCFG_ENBL_MASK;
+	}
+
+	DMA_Channel_priority(ch, priority);
+}
+
+/*!
+ * Allocate a DMA channel
+ * ===================================================
+ * Take the first free channel for the given request source and priority.
+ *
+ * @param[dma_request_source_t source] Request source routed to the channel
+ * @param[DMA_Priority_t priority] Priority class of the channel
+ *
+ * @return Allocated channel or DMA_CH_NONE if all of them are in use.
+ */
+uint8_t DMA_Channel_alloc(dma_request_source_t source, DMA_Priority_t priority)
+{
+	uint8_t ch;
+
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		if (DMA_Channels[ch].used == 0u) {
+			DMA_Channel_reserve(ch, source, priority);
+			return ch;
+		}
+	}
+	return DMA_CH_NONE;
+}
+
+/*!
+ * Free a DMA channel: its requests and DMAMUX routing are disabled. It keeps
+ * its priority level, still unique, until it is reserved again.
+ */
+void DMA_Channel_free(uint8_t ch)
+{
+	DEV_ASSERT(ch < DMA_TCD_COUNT);
+
+	DMA->CERQ = DMA_CERQ_CERQ(ch);	/* Disable requests of the channel */
+	DMAMUX->CHCFG[ch] = 0;			/* Disable the DMAMUX channel */
+	DMA_Channels[ch].used     = 0;
+	DMA_Channels[ch].priority = DMA_PRIO_BULK;
+	DMA_Channels[ch].source   = EDMA_REQ_DISABLED;
+}
+
+/*!
+ * Channel allocation table (one entry per DMA channel), to be inspected
+ * from a debugger or reported by the application.
+ */
+const DMA_Channel_entry_t * DMA_Channel_table(void)
+{
+	return DMA_Channels;
+}
+
 /*!
  * TCD0: Transfers string to a single memory location
  * ===================================================
@@ -56,40 +203,11 @@ void DMA_init(void)
  */
 void DMA_TCD_init(void)
 {
-
-  DMA->TCD[0].SADDR        = DMA_TCD_SADDR_SADDR((uint32_t volatile) &TCD0_Source); /* Source Address. */
-  DMA->TCD[0].SOFF         = DMA_TCD_SOFF_SOFF(1);   /* Src. addr add 1 byte after Transfers   */
-  DMA->TCD[0].ATTR         = DMA_TCD_ATTR_SMOD(0)  | /* Src. modulo feature not used */
-                             DMA_TCD_ATTR_SSIZE(0) | /* Src. read 2**0 =1 byte per transfer */
-                             DMA_TCD_ATTR_DMOD(0)  | /* Dest. modulo feature not used */
-                             DMA_TCD_ATTR_DSIZE(0);  /* Dest. write 2**0 =1 byte per trans. */
-
-  DMA->TCD[0].NBYTES.MLNO  = DMA_TCD_NBYTES_MLNO_NBYTES(1); /* Transfer 1 byte /minor loop */
-  DMA->TCD[0].SLAST        = DMA_TCD_SLAST_SLAST(-11); 		/* Src addr change after major loop */
-
-  DMA->TCD[0].DADDR        = DMA_TCD_DADDR_DADDR((uint32_t volatile) &TCD0_Dest);	/* Destination Address. */
-  DMA->TCD[0].DOFF         = DMA_TCD_DOFF_DOFF(0);     			/* No dest adr offset after transfer */
-  DMA->TCD[0].CITER.ELINKNO= DMA_TCD_CITER_ELINKNO_CITER(11) | 	/* 11 minor loop iterations */
-                             DMA_TCD_CITER_ELINKNO_ELINK(0);   	/* No minor loop chan link */
-
-  DMA->TCD[0].DLASTSGA     = DMA_TCD_DLASTSGA_DLASTSGA(0); /* No dest chg after major loop */
-  DMA->TCD[0].CSR          = DMA_TCD_CSR_START(0)       |  /* Clear START status flag */
-                             DMA_TCD_CSR_INTMAJOR(0)    |  /* No IRQ after major loop */
-                             DMA_TCD_CSR_INTHALF(0)     |  /* No IRQ after 1/2 major loop */
-                             DMA_TCD_CSR_DREQ(1)        |  /* Disable chan after major loop */
-                             DMA_TCD_CSR_ESG(0)         |  /* Disable Scatter Gather */
-                             DMA_TCD_CSR_MAJORELINK(0)  |  /* No major loop chan link */
-                             DMA_TCD_CSR_ACTIVE(0)      |  /* Clear ACTIVE status flag */
-                             DMA_TCD_CSR_DONE(0)        |  /* Clear DONE status flag */
-                             DMA_TCD_CSR_MAJORLINKCH(0) |  /* Chan # if major loop ch link */
-                             DMA_TCD_CSR_BWC(0);           /* No eDMA stalls after R/W */
-  DMA->TCD[0].BITER.ELINKNO= DMA_TCD_BITER_ELINKNO_BITER(11) |  /* Initial iteration count */
-                             DMA_TCD_BITER_ELINKNO_ELINK(0);    /* No minor loop chan link */
+  DMA_TCD_Load(0, &TCD_init_image);	/* Load TCD0 from its flash image */
 }
 
 void DMA_SG_init(void){
-	PCC->PCCn[PCC_DMAMUX_INDEX] |= PCC_PCCn_CGC_MASK;	/* Enable clock for DMAMUX */
-	DMAMUX->CHCFG[0] = DMAMUX_CHCFG_SOURCE(EDMA_REQ_DMAMUX_ALWAYS_ENABLED0) | DMAMUX_CHCFG_ENBL_MASK;	/* Keep the trigger always enabled for DMACH0 and turn on Enable CH0 */
+	DMA_Channel_reserve(0, EDMA_REQ_DMAMUX_ALWAYS_ENABLED0, DMA_PRIO_NORMAL);	/* Keep the trigger always enabled for DMACH0 and turn on Enable CH0 */
 }
 
 /*!
@@ -172,6 +290,108 @@ void DMA_TCD_Push(uint8_t ch, TCD_t * TCDm )
    DMA->TCD[ch].BITER.ELINKNO= TCDm->BITER_ELINKNO;
 }
 
+/*!
+* Load a TCD image into the DMA Channel
+* ===================================================
+* Copy a complete TCD image (usually a const table in flash built with
+* DMA_TCD_IMAGE) into the TCD of the desired DMA channel as a block of
+* eight 32-bit writes instead of one access per field. CSR is written in
+* the last word, after DLASTSGA, as required when ESG is set.
+*
+* @param[uint8_t ch] DMA channel where you want to apply the TCD configuration
+* @param[const TCD_t * TCDm] Pointer to the TCD image to be applied.
+*
+*/
+void DMA_TCD_Load(uint8_t ch, const TCD_t * TCDm)
+{
+	const uint32_t * src = (const uint32_t *) TCDm;
+	uint32_t volatile * dst = (uint32_t volatile *) &DMA->TCD[ch];
+
+	dst[0] = src[0];	/* SADDR */
+	dst[1] = src[1];	/* SOFF | ATTR */
+	dst[2] = src[2];	/* NBYTES */
+	dst[3] = src[3];	/* SLAST */
+	dst[4] = src[4];	/* DADDR */
+	dst[5] = src[5];	/* DOFF | CITER */
+	dst[6] = src[6];	/* DLASTSGA */
+	dst[7] = src[7];	/* CSR | BITER */
+}
+
+/*!
+* Read the TCD of a DMA Channel
+* ===================================================
+* Copy the TCD currently programmed in a channel into a TCD_t, e.g. to
+* evaluate configurations written field by field with DMA_TCD_Stats.
+*
+* @param[uint8_t ch] DMA channel to read
+* @param[TCD_t * TCDm] Where the TCD is saved
+*
+*/
+void DMA_TCD_Read(uint8_t ch, TCD_t * TCDm)
+{
+	uint32_t * dst = (uint32_t *) TCDm;
+	uint32_t volatile * src = (uint32_t volatile *) &DMA->TCD[ch];
+	uint8_t i;
+
+	for (i = 0; i < 8u; i++) {
+		dst[i] = src[i];
+	}
+}
+
+/*!
+* TCD efficiency figures
+* ===================================================
+* Work out from a TCD image what one major loop costs: bytes moved, bus
+* accesses on each side, Scatter Gather fetches, link events and interrupt
+* requests. Lets different configurations of the same transfer (e.g. the
+* channels read back with DMA_TCD_Read after DMA_TCD_LC_Config,
+* DMA_TCD_FlexScan_Config or DMA_Config) be compared without a logic analyzer.
+* Only the image is read, so it can also be evaluated off target.
+*
+* @param[const TCD_t * TCDm] TCD image to evaluate
+* @param[uint8_t emlm] DMA->CR[EMLM] the image runs with, selects how NBYTES is decoded
+*                      (1 for DMA_TCD_Deinterleave_Config, 0 for the other features)
+* @param[DMA_TCD_Stats_t * stats] Result
+*
+*/
+void DMA_TCD_Stats(const TCD_t * TCDm, uint8_t emlm, DMA_TCD_Stats_t * stats)
+{
+	uint32_t nbytes;
+	uint16_t iter;
+	uint8_t ssize = (uint8_t)((TCDm->ATTR & DMA_TCD_ATTR_SSIZE_MASK) >> DMA_TCD_ATTR_SSIZE_SHIFT);
+	uint8_t dsize = (uint8_t)((TCDm->ATTR & DMA_TCD_ATTR_DSIZE_MASK) >> DMA_TCD_ATTR_DSIZE_SHIFT);
+	uint8_t elink = (TCDm->BITER_ELINKNO & DMA_TCD_BITER_ELINKNO_ELINK_MASK) ? 1u : 0u;
+
+	if (emlm == 0u) {
+		nbytes = TCDm->NBYTES_MLNO;
+	}
+	else if (TCDm->NBYTES_MLOFFYES & (DMA_TCD_NBYTES_MLOFFYES_SMLOE_MASK | DMA_TCD_NBYTES_MLOFFYES_DMLOE_MASK)) {
+		nbytes = TCDm->NBYTES_MLOFFYES & DMA_TCD_NBYTES_MLOFFYES_NBYTES_MASK;
+	}
+	else {
+		nbytes = TCDm->NBYTES_MLOFFNO & DMA_TCD_NBYTES_MLOFFNO_NBYTES_MASK;
+	}
+
+	iter = elink ? (TCDm->BITER_ELINKYES & DMA_TCD_BITER_ELINKYES_BITER_MASK)
+				 : (TCDm->BITER_ELINKNO & DMA_TCD_BITER_ELINKNO_BITER_MASK);
+
+	if (ssize > 2u) {
+		ssize = 2u;		/* Bursts are done in 32-bit beats */
+	}
+	if (dsize > 2u) {
+		dsize = 2u;
+	}
+
+	stats->bytes       = nbytes * iter;
+	stats->read_beats  = stats->bytes >> ssize;
+	stats->write_beats = stats->bytes >> dsize;
+	stats->tcd_beats   = (TCDm->CSR & DMA_TCD_CSR_ESG_MASK) ? (sizeof(TCD_t) / 4u) : 0u;
+	stats->minor_links = (elink && (iter > 0u)) ? (uint16_t)(iter - 1u) : 0u;	/* Last minor loop gives way to the major link */
+	stats->major_links = (TCDm->CSR & DMA_TCD_CSR_MAJORELINK_MASK) ? 1u : 0u;
+	stats->interrupts  = ((TCDm->CSR & DMA_TCD_CSR_INTMAJOR_MASK) ? 1u : 0u) +
+						 ((TCDm->CSR & DMA_TCD_CSR_INTHALF_MASK) ? 1u : 0u);
+}
+
 /*! Configuration of the DMA for CAN Node 2
  * 	=====================================================
  * 	Enable DMA channel 3 for data transfer from 4 channels of the ADC0
@@ -182,13 +402,8 @@ void DMA_TCD_Push(uint8_t ch, TCD_t * TCDm )
  *
  */
 void DMA_Config(uint32_t Destination[4]){
-	SIM->PLATCGC |= SIM_PLATCGC_CGCDMA_MASK;			/* DMA Clock Gating Control Enable */
-
-	PCC->PCCn[PCC_DMAMUX_INDEX] |= PCC_PCCn_CGC_MASK;	/* Enable DMA Clock */
-
-	DMAMUX->CHCFG[3] &=~ DMAMUX_CHCFG_ENBL_MASK;        /* Disabling the DMA channel 3 */
-	DMAMUX->CHCFG[3] |= DMAMUX_CHCFG_SOURCE(42);        /* ADC0 COCO is the source of the DMA channel 3 */
-	DMAMUX->CHCFG[3] |= DMAMUX_CHCFG_ENBL_MASK;         /* Enable the DMA channel 3 */
+	DMA_Channel_reserve(3, EDMA_REQ_ADC0, DMA_PRIO_CRITICAL);	/* ADC0 COCO is the source of the DMA channel 3 */
+	DMA_Channel_reserve(1, EDMA_REQ_DISABLED, DMA_PRIO_CRITICAL);	/* Channel 1 is linked after the major loop */
 
 	/* Configure TCD*/
 	//Source
@@ -220,11 +435,40 @@ void DMA_Config(uint32_t Destination[4]){
  */
 
 void DMAMUX_LC_init(void){
-	PCC->PCCn[PCC_DMAMUX_INDEX] |= PCC_PCCn_CGC_MASK;	/* Enable clock for DMAMUX */
-	DMAMUX->CHCFG[0] = DMAMUX_CHCFG_SOURCE(EDMA_REQ_DMAMUX_ALWAYS_ENABLED0) | DMAMUX_CHCFG_ENBL_MASK;	/* Keep the trigger always enabled for DMACH0 and turn on Enable CH0 */
+	DMA_Channel_reserve(0, EDMA_REQ_DMAMUX_ALWAYS_ENABLED0, DMA_PRIO_NORMAL);	/* Keep the trigger always enabled for DMACH0 and turn on Enable CH0 */
+	DMA_Channel_reserve(1, EDMA_REQ_DISABLED, DMA_PRIO_NORMAL);				/* CH1 is only started by the link from CH0 */
 }
 
 
+/* TCD images of the Linking Channel feature: CH0 copies 6 bytes linking to CH1 after each
+ * minor loop, CH1 copies the remaining 5 bytes and raises its IRQ after the major loop. */
+DMA_TCD_DEFINE(TCD_LC_CH0_image,
+			   &TCD0_Source[0],			/* Source Address. */
+			   1,						/* Src. addr add 1 byte after Transfers */
+			   &TCD_LC_Dest[0],			/* Destination Address. */
+			   1,						/* Dest. adr add 1 byte after transfers */
+			   0, 0,					/* Src./Dest. 2**0 =1 byte per transfer, no modulo */
+			   1,						/* Transfer 1 byte /minor loop */
+			   -6,						/* Src addr change -6 bytes after major loop */
+			   -6,						/* Dest. chg -6 bytes after major loop */
+			   6,						/* 6 minor loop iterations */
+			   1,						/* Link to channel 1 after minor loop */
+			   DMA_TCD_CSR_DREQ(1));	/* Disable chan after major loop */
+
+DMA_TCD_DEFINE(TCD_LC_CH1_image,
+			   &TCD0_Source[6],			/* Source Address. */
+			   1,						/* Src. addr add 1 byte after Transfers */
+			   &TCD_LC_Dest[6],			/* Destination Address. */
+			   1,						/* Dest. adr add 1 byte after transfer */
+			   0, 0,					/* Src./Dest. 2**0 =1 byte per transfer, no modulo */
+			   1,						/* Transfer 1 byte /minor loop */
+			   -5,						/* Src addr change -5 bytes after major loop */
+			   -5,						/* Dest chg -5 bytes after major loop */
+			   5,						/* 5 minor loop iterations */
+			   DMA_TCD_NO_LINK,			/* No minor loop chan link */
+			   DMA_TCD_CSR_INTMAJOR(1) |	/* IRQ after major loop */
+			   DMA_TCD_CSR_DREQ(1));	/* Disable chan after major loop */
+
 /*!
  * DMA Linking Channel Feature
  * ===================================================
@@ -234,68 +478,8 @@ void DMAMUX_LC_init(void){
  *
  */
 void DMA_TCD_LC_Config(void){
-	  DMA->TCD[0].SADDR        = DMA_TCD_SADDR_SADDR((uint32_t volatile) &TCD0_Source[0]); /* Source Address. */
-	  DMA->TCD[0].SOFF         = DMA_TCD_SOFF_SOFF(1);   /* Src. addr add 1 byte after Transfers   */
-	  DMA->TCD[0].ATTR         = DMA_TCD_ATTR_SMOD(0)  | /* Src. modulo feature not used */
-	                             DMA_TCD_ATTR_SSIZE(0) | /* Src. read 2**0 =1 byte per transfer */
-	                             DMA_TCD_ATTR_DMOD(0)  | /* Dest. modulo feature not used */
-	                             DMA_TCD_ATTR_DSIZE(0);  /* Dest. write 2**0 =1 byte per trans. */
-
-	  DMA->TCD[0].NBYTES.MLNO  = DMA_TCD_NBYTES_MLNO_NBYTES(1); /* Transfer 1 byte /minor loop */
-	  DMA->TCD[0].SLAST        = DMA_TCD_SLAST_SLAST(-6); 		/* Src addr change -6 bytes after major loop */
-
-	  DMA->TCD[0].DADDR        = DMA_TCD_DADDR_DADDR((uint32_t volatile) &TCD_LC_Dest[0]);	/* Destination Address. */
-	  DMA->TCD[0].DOFF         = DMA_TCD_DOFF_DOFF(1);     			/* Dest. adr add 1 byte after transfers */
-	  DMA->TCD[0].CITER.ELINKYES= DMA_TCD_CITER_ELINKYES_CITER_LE(6)| 	/* 6 minor loop iterations */
-	  	  	  	  	  	  	  	 DMA_TCD_CITER_ELINKYES_ELINK_MASK|	/* Enable Linking Channel after Minor Loop */
-			  	  	  	  	  	 DMA_TCD_CITER_ELINKYES_LINKCH(1);  /* Link to channel 1 after minor loop */
-
-	  DMA->TCD[0].DLASTSGA     = DMA_TCD_DLASTSGA_DLASTSGA(-6); /* Dest. chg -6 bytes after major loop */
-	  DMA->TCD[0].CSR          = DMA_TCD_CSR_START(0)       |  /* Clear START status flag */
-	                             DMA_TCD_CSR_INTMAJOR(0)    |  /* No IRQ after major loop */
-	                             DMA_TCD_CSR_INTHALF(0)     |  /* No IRQ after 1/2 major loop */
-	                             DMA_TCD_CSR_DREQ(1)        |  /* Disable chan after major loop */
-	                             DMA_TCD_CSR_ESG(0)         |  /* Disable Scatter Gather */
-	                             DMA_TCD_CSR_MAJORELINK(0)  |  /* Activate major loop chan link */
-	                             DMA_TCD_CSR_ACTIVE(0)      |  /* Clear ACTIVE status flag */
-	                             DMA_TCD_CSR_DONE(0)        |  /* Clear DONE status flag */
-	                             DMA_TCD_CSR_MAJORLINKCH(0) |  /* Chan # if major loop ch link (Channel 1 in this case) */
-	                             DMA_TCD_CSR_BWC(0);           /* No eDMA stalls after R/W */
-	  DMA->TCD[0].BITER.ELINKYES= DMA_TCD_BITER_ELINKYES_BITER(6) |  /* Initial iteration count */
-			  	  	  	  	  	 DMA_TCD_BITER_ELINKYES_ELINK_MASK|   /*  Minor loop Linking Channel */
-	  	  	  	  	  	  	  	 DMA_TCD_BITER_ELINKYES_LINKCH(1);	/* Minor Loop to CH 1 */
-
-
-	  /*Set up DMA TCD CH 1 */
-
-	  DMA->TCD[1].SADDR        = DMA_TCD_SADDR_SADDR((uint32_t volatile) &TCD0_Source[6]); /* Source Address. */
-	  DMA->TCD[1].SOFF         = DMA_TCD_SOFF_SOFF(1);   /* Src. addr add 1 byte after Transfers   */
-	  DMA->TCD[1].ATTR         = DMA_TCD_ATTR_SMOD(0)  | /* Src. modulo feature not used */
-			  	  	  	  	  	  DMA_TCD_ATTR_SSIZE(0) | /* Src. read 2**0 =1 byte per transfer */
-								  DMA_TCD_ATTR_DMOD(0)  | /* Dest. modulo feature not used */
-								  DMA_TCD_ATTR_DSIZE(0);  /* Dest. write 2**0 =1 byte per trans. */
-
-	  DMA->TCD[1].NBYTES.MLNO  = DMA_TCD_NBYTES_MLNO_NBYTES(1); /* Transfer 1 byte /minor loop */
-	  DMA->TCD[1].SLAST        = DMA_TCD_SLAST_SLAST(-5); 		/* Src addr change -5 bytes after major loop */
-
-	  DMA->TCD[1].DADDR        = DMA_TCD_DADDR_DADDR((uint32_t volatile) &TCD_LC_Dest[6]);	/* Destination Address. */
-	  DMA->TCD[1].DOFF         = DMA_TCD_DOFF_DOFF(1);     			/* Dest. adr add 1 byte after transfer */
-	  DMA->TCD[1].CITER.ELINKNO= DMA_TCD_CITER_ELINKNO_CITER(5) | 	/* 5 minor loop iterations */
-			  	  	  	  	  	 DMA_TCD_CITER_ELINKNO_ELINK(0);   	/* No minor loop chan link */
-
-	  DMA->TCD[1].DLASTSGA     = DMA_TCD_DLASTSGA_DLASTSGA(-5); /* Dest chg -5 bytes after major loop */
-	  DMA->TCD[1].CSR          = DMA_TCD_CSR_START(0)       |  /* Clear START status flag */
-	                           DMA_TCD_CSR_INTMAJOR(1)    |  /* IRQ after major loop */
-	                           DMA_TCD_CSR_INTHALF(0)     |  /* No IRQ after 1/2 major loop */
-	                           DMA_TCD_CSR_DREQ(1)        |  /* Disable chan after major loop */
-	                           DMA_TCD_CSR_ESG(0)         |  /* Disable Scatter Gather */
-	                           DMA_TCD_CSR_MAJORELINK(0)  |  /* No major loop chan link */
-	                           DMA_TCD_CSR_ACTIVE(0)      |  /* Clear ACTIVE status flag */
-	                           DMA_TCD_CSR_DONE(0)        |  /* Clear DONE status flag */
-	                           DMA_TCD_CSR_MAJORLINKCH(0) |  /* Chan # if major loop ch link */
-	                           DMA_TCD_CSR_BWC(0);           /* No eDMA stalls after R/W */
-	  DMA->TCD[1].BITER.ELINKNO= DMA_TCD_BITER_ELINKNO_BITER(5) |  /* Initial iteration count */
-	                           DMA_TCD_BITER_ELINKNO_ELINK(0);    /* No minor loop chan link */
+	DMA_TCD_Load(0, &TCD_LC_CH0_image);	/* Set up DMA TCD CH 0 */
+	DMA_TCD_Load(1, &TCD_LC_CH1_image);	/* Set up DMA TCD CH 1 */
 }
 
 /*!
@@ -305,11 +489,42 @@ void DMA_TCD_LC_Config(void){
  */
 
 void DMAMUX_FlexScan_init(void){
-	PCC->PCCn[PCC_DMAMUX_INDEX] |= PCC_PCCn_CGC_MASK;	/* Enable clock for DMAMUX */
-	DMAMUX->CHCFG[0] = DMAMUX_CHCFG_SOURCE(EDMA_REQ_ADC0) | DMAMUX_CHCFG_ENBL_MASK;	/* Set to receive trigger from the ADC to DMACH0 and turn on Enable CH0 */
+	DMA_Channel_reserve(0, EDMA_REQ_ADC0, DMA_PRIO_CRITICAL);		/* Set to receive trigger from the ADC to DMACH0 and turn on Enable CH0 */
+	DMA_Channel_reserve(1, EDMA_REQ_DISABLED, DMA_PRIO_CRITICAL);	/* CH1 rewrites ADC0 SC1A when linked from CH0 */
 }
 
 
+/* TCD images of the FlexScan feature: CH0 moves each ADC0 result to ADC_Results[] and links to
+ * CH1, which writes the next entry of ADC_SC1A_CH[] into ADC0 SC1A. */
+DMA_TCD_DEFINE(TCD_FlexScan_CH0_image,
+			   &(ADC0->R[0]),			/* Source Address to ADC0 Result Register */
+			   0,						/* Stay the same source address after Transfers */
+			   &ADC_Results[0],			/* Destination Address to ADC_Results array. */
+			   4,						/* Dest. adr add 4 bytes after transfers */
+			   2, 2,					/* Src./Dest. 32 bits per transfer, no modulo */
+			   4,						/* Transfer 4 byte /minor loop */
+			   0,						/* No Source Address change after major loop */
+			   -48,						/* Dest. chg -48 bytes after major loop */
+			   12,						/* 12 minor loop iterations */
+			   1,						/* Link to channel 1 after minor loop */
+			   DMA_TCD_CSR_INTMAJOR(1)  |	/* IRQ after major loop */
+			   DMA_TCD_CSR_DREQ(1)      |	/* Disable chan after major loop */
+			   DMA_TCD_CSR_MAJORELINK(1)|	/* Activate major loop chan link */
+			   DMA_TCD_CSR_MAJORLINKCH(1));	/* Chan # if major loop ch link (Channel 1 in this case) */
+
+DMA_TCD_DEFINE(TCD_FlexScan_CH1_image,
+			   &ADC_SC1A_CH[0],			/* Source Address to Array with ADC channels to read */
+			   4,						/* Src. addr add 4 byte after Transfers */
+			   &(ADC0->SC1[0]),			/* Destination Address to ADC SC1_A register */
+			   0,						/* No destination change after transfer */
+			   2, 2,					/* Src./Dest. 32 bits per transfer, no modulo */
+			   4,						/* Transfers 4 byte /minor loop */
+			   -12,						/* Src addr change -12 bytes after major loop */
+			   0,						/* No dest. change after major loop */
+			   3,						/* 3 minor loop iterations */
+			   DMA_TCD_NO_LINK,			/* No minor loop chan link */
+			   DMA_TCD_CSR_DREQ(1));	/* Disable chan after major loop */
+
 /*!
  * DMA  Feature
  * ===================================================
@@ -319,68 +534,793 @@ void DMAMUX_FlexScan_init(void){
  *
  */
 void DMA_TCD_FlexScan_Config(void){
-	  DMA->TCD[0].SADDR        = DMA_TCD_SADDR_SADDR((uint32_t volatile) &(ADC0->R[0])); /* Source Address to ADC0 Result Register */
-	  DMA->TCD[0].SOFF         = DMA_TCD_SOFF_SOFF(0);   /* Stay the same source address after Transfers   */
-	  DMA->TCD[0].ATTR         = DMA_TCD_ATTR_SMOD(0)  | /* Src. modulo feature not used */
-	                             DMA_TCD_ATTR_SSIZE(2) | /* Src. read 32 bits per transfer */
-	                             DMA_TCD_ATTR_DMOD(0)  | /* Dest. modulo feature not used */
-	                             DMA_TCD_ATTR_DSIZE(2);  /* Dest. write 32 bits per trans. */
-
-	  DMA->TCD[0].NBYTES.MLNO  = DMA_TCD_NBYTES_MLNO_NBYTES(4); /* Transfer 4 byte /minor loop */
-	  DMA->TCD[0].SLAST        = DMA_TCD_SLAST_SLAST(0); 		/* No Source Address change after major loop */
-
-	  DMA->TCD[0].DADDR        = DMA_TCD_DADDR_DADDR((uint32_t volatile) &ADC_Results[0]);	/* Destination Address to ADC_Results array. */
-	  DMA->TCD[0].DOFF         = DMA_TCD_DOFF_DOFF(4);     			/* Dest. adr add 4 bytes after transfers */
-	  DMA->TCD[0].CITER.ELINKYES=DMA_TCD_CITER_ELINKYES_CITER_LE(12)| 	/* 12 minor loop iterations */
-	  	  	  	  	  	  	  	 DMA_TCD_CITER_ELINKYES_ELINK_MASK|	/* Enable Linking Channel after Minor Loop */
-			  	  	  	  	  	 DMA_TCD_CITER_ELINKYES_LINKCH(1);  /* Link to channel 1 after minor loop */
-
-	  DMA->TCD[0].DLASTSGA     = DMA_TCD_DLASTSGA_DLASTSGA(-48); /* Dest. chg -48 bytes after major loop */
-	  DMA->TCD[0].CSR          = DMA_TCD_CSR_START(0)       |  /* Clear START status flag */
-	                             DMA_TCD_CSR_INTMAJOR(1)    |  /* IRQ after major loop */
-	                             DMA_TCD_CSR_INTHALF(0)     |  /* No IRQ after 1/2 major loop */
-	                             DMA_TCD_CSR_DREQ(1)        |  /* Disable chan after major loop */
-	                             DMA_TCD_CSR_ESG(0)         |  /* Disable Scatter Gather */
-	                             DMA_TCD_CSR_MAJORELINK(1)  |  /* Activate major loop chan link */
-	                             DMA_TCD_CSR_ACTIVE(0)      |  /* Clear ACTIVE status flag */
-	                             DMA_TCD_CSR_DONE(0)        |  /* Clear DONE status flag */
-	                             DMA_TCD_CSR_MAJORLINKCH(1) |  /* Chan # if major loop ch link (Channel 1 in this case) */
-	                             DMA_TCD_CSR_BWC(0);           /* No eDMA stalls after R/W */
-	  DMA->TCD[0].BITER.ELINKYES= DMA_TCD_BITER_ELINKYES_BITER(12)|  /* Initial iteration count */
-	  	  	  	  	  	  	  	 DMA_TCD_BITER_ELINKYES_ELINK_MASK|	/* Enable Linking Channel after Minor Loop */
-			  	  	  	  	  	 DMA_TCD_BITER_ELINKYES_LINKCH(1); /* Minor loop Linking Channel */
-
-
-	  /*Set up DMA TCD CH 1 */
-
-	  DMA->TCD[1].SADDR        = DMA_TCD_SADDR_SADDR((uint32_t volatile) &ADC_SC1A_CH[0]); /* Source Address to Array with ADC channels to read */
-	  DMA->TCD[1].SOFF         = DMA_TCD_SOFF_SOFF(4);   /* Src. addr add 4 byte after Transfers   */
-	  DMA->TCD[1].ATTR         = DMA_TCD_ATTR_SMOD(0)  | /* Src. modulo feature not used */
-			  	  	  	  	  	  DMA_TCD_ATTR_SSIZE(2) | /* Src. read 32 bits per transfer */
-								  DMA_TCD_ATTR_DMOD(0)  | /* Dest. modulo feature not used */
-								  DMA_TCD_ATTR_DSIZE(2);  /* Dest. write 32 bits per trans. */
-
-	  DMA->TCD[1].NBYTES.MLNO  = DMA_TCD_NBYTES_MLNO_NBYTES(4); /* Transfers 4 byte /minor loop */
-	  DMA->TCD[1].SLAST        = DMA_TCD_SLAST_SLAST(-12); 		/* Src addr change -12 bytes after major loop */
-
-	  DMA->TCD[1].DADDR        = DMA_TCD_DADDR_DADDR((uint32_t volatile) &(ADC0->SC1[0]));	/* Destination Address to ADC SC1_A register*/
-	  DMA->TCD[1].DOFF         = DMA_TCD_DOFF_DOFF(0);     			/* No destination change after transfer */
-	  DMA->TCD[1].CITER.ELINKNO= DMA_TCD_CITER_ELINKNO_CITER(3) | 	/* 3 minor loop iterations */
-			  	  	  	  	  	 DMA_TCD_CITER_ELINKNO_ELINK(0);   	/* No minor loop chan link */
-
-	  DMA->TCD[1].DLASTSGA     = DMA_TCD_DLASTSGA_DLASTSGA(0); /* No dest. change after major loop */
-	  DMA->TCD[1].CSR          = DMA_TCD_CSR_START(0)       |  /* Clear START status flag */
-	                           DMA_TCD_CSR_INTMAJOR(0)    |  /* No IRQ after major loop */
-	                           DMA_TCD_CSR_INTHALF(0)     |  /* No IRQ after 1/2 major loop */
-	                           DMA_TCD_CSR_DREQ(1)        |  /* Disable chan after major loop */
-	                           DMA_TCD_CSR_ESG(0)         |  /* Disable Scatter Gather */
-	                           DMA_TCD_CSR_MAJORELINK(0)  |  /* No major loop chan link */
-	                           DMA_TCD_CSR_ACTIVE(0)      |  /* Clear ACTIVE status flag */
-	                           DMA_TCD_CSR_DONE(0)        |  /* Clear DONE status flag */
-	                           DMA_TCD_CSR_MAJORLINKCH(0) |  /* Chan # if major loop ch link */
-	                           DMA_TCD_CSR_BWC(0);           /* No eDMA stalls after R/W */
-	  DMA->TCD[1].BITER.ELINKNO= DMA_TCD_BITER_ELINKNO_BITER(3) |  /* Initial iteration count */
-	                           DMA_TCD_BITER_ELINKNO_ELINK(0);    /* No minor loop chan link */
+	DMA_TCD_Load(0, &TCD_FlexScan_CH0_image);	/* Set up DMA TCD CH 0 */
+	DMA_TCD_Load(1, &TCD_FlexScan_CH1_image);	/* Set up DMA TCD CH 1 */
+}
+
+
+
+static uint32_t volatile * FlexScan_Stream_buffer;	/*< Caller buffer of the continuous FlexScan mode */
+static uint16_t FlexScan_Stream_half;				/*< Samples per half of the buffer */
+static DMA_Half_callback_t FlexScan_Stream_callback;	/*< Called once per filled half */
+
+/*!
+ * DMA FlexScan continuous mode
+ * ===================================================
+ * Same channel setup as DMA_TCD_FlexScan_Config, but CH0 fills a caller
+ * supplied buffer as a ping-pong: it raises an interrupt when each half is
+ * filled, wraps back to the start of the buffer after the major loop and
+ * keeps its requests enabled, so acquisition never stops. The application
+ * processes one half in the callback while the eDMA fills the other one.
+ *
+ * @param[uint32_t volatile * buffer] Destination of the ADC results
+ * @param[uint16_t size] Amount of samples of the buffer (up to 510 with minor loop linking), a
+ *                       multiple of twice the channels of ADC_SC1A_CH so each half holds whole scans
+ * @param[DMA_Half_callback_t callback] Function called from DMA_FlexScan_Stream_IRQ with each filled half
+ *
+ */
+void DMA_TCD_FlexScan_Stream_Config(uint32_t volatile * buffer, uint16_t size, DMA_Half_callback_t callback)
+{
+	TCD_t TCDm = TCD_FlexScan_CH0_image;
+
+	DEV_ASSERT((size > 0u) && (size <= 0x1FEu));
+	DEV_ASSERT((size % (2u * ADC_SC1A_CH_COUNT)) == 0u);	/* Halves start on the first channel of a scan */
+
+	FlexScan_Stream_buffer   = buffer;
+	FlexScan_Stream_half     = size / 2u;
+	FlexScan_Stream_callback = callback;
+
+	TCDm.DADDR          = DMA_TCD_DADDR_DADDR((uint32_t) buffer);				/* Destination Address to the stream buffer */
+	TCDm.DLASTSGA       = DMA_TCD_DLASTSGA_DLASTSGA(-(4 * (int32_t) size));	/* Wrap to the start of the buffer after major loop */
+	TCDm.CITER_ELINKYES = DMA_TCD_ITER_LINK(size, 1);							/* One minor loop per sample, link to channel 1 */
+	TCDm.BITER_ELINKYES = DMA_TCD_ITER_LINK(size, 1);
+	TCDm.CSR            = DMA_TCD_CSR_INTMAJOR(1)  |	/* IRQ when the second half is filled */
+						  DMA_TCD_CSR_INTHALF(1)   |	/* IRQ when the first half is filled */
+						  DMA_TCD_CSR_DREQ(0)      |	/* Keep chan active after major loop */
+						  DMA_TCD_CSR_MAJORELINK(1)|	/* Activate major loop chan link */
+						  DMA_TCD_CSR_MAJORLINKCH(1);	/* Chan # if major loop ch link (Channel 1 in this case) */
+
+	DMA_TCD_Load(0, &TCDm);						/* Set up DMA TCD CH 0 */
+	DMA_TCD_Load(1, &TCD_FlexScan_CH1_image);	/* Set up DMA TCD CH 1 */
+}
+
+/*!
+ * DMA FlexScan continuous mode interrupt
+ * ===================================================
+ * To be called from DMA0_IRQHandler. DONE tells which half has just been
+ * filled: clear at the half point, set after the major loop.
+ */
+void DMA_FlexScan_Stream_IRQ(void)
+{
+	uint32_t volatile * samples = FlexScan_Stream_buffer;
+
+	DMA->CINT = DMA_CINT_CINT(0);	/* Clear Interruption request flag of DMA Channel 0 */
+
+	if ((DMA->TCD[0].CSR & DMA_TCD_CSR_DONE_MASK) != 0u) {
+		DMA->CDNE = DMA_CDNE_CDNE(0);	/* Clear Done Status Flag of DMA Channel 0 */
+		samples += FlexScan_Stream_half;	/* Second half filled, eDMA is back on the first one */
+	}
+
+	if (FlexScan_Stream_callback != 0) {
+		FlexScan_Stream_callback(samples, FlexScan_Stream_half);
+	}
+}
+
+/*!
+ * DMA De-interleave Feature
+ * ===================================================
+ * Set up a channel to scatter the results of a scan of several ADC slots
+ * into one contiguous array per slot (dest[slot][sample]). Each request
+ * (one per complete scan) runs a minor loop that reads the result registers
+ * of the scan and writes every result "depth" words apart, then the minor
+ * loop offset (EMLM) moves the destination back to the next sample of the
+ * first array. The source wraps over the result registers with the source
+ * modulo, so the block of results read must be aligned to its size: with 4
+ * slots use SC1[2..5] or SC1[6..9], with 2 slots SC1[0..1], SC1[2..3]...
+ * INTMAJOR is raised every time the arrays are full, then they are refilled.
+ *
+ * @param[uint8_t ch] DMA channel
+ * @param[uint32_t volatile * source] First result register of the scan (e.g. &ADC0->R[2])
+ * @param[uint8_t channels] Slots of the scan (power of two)
+ * @param[uint32_t * dest] First element of a [channels][depth] array
+ * @param[uint16_t depth] Samples per slot (up to 8191, and channels * depth up to 131072)
+ *
+ */
+void DMA_TCD_Deinterleave_Config(uint8_t ch, uint32_t volatile * source, uint8_t channels, uint32_t * dest, uint16_t depth)
+{
+	TCD_t TCDm;
+	uint8_t smod = 0;
+
+	while ((1u << smod) < (4u * channels)) {
+		smod++;		/* Source modulo covering all the result registers of the scan */
+	}
+	DEV_ASSERT((1u << smod) == (4u * channels));				/* channels must be a power of two */
+	DEV_ASSERT(((uint32_t) source & ((1u << smod) - 1u)) == 0u);	/* results block aligned to its size */
+	DEV_ASSERT((depth > 0u) && (depth <= 8191u));				/* DOFF = 4 * depth fits the signed 16-bit field */
+	DEV_ASSERT(((uint32_t) channels * depth) <= 0x20000u);		/* MLOFF = 4 - 4 * channels * depth fits signed 20 bits */
+
+	DMA->CR |= DMA_CR_EMLM_MASK;	/* Enable minor loop mapping (NBYTES_MLOFFNO/YES) */
+
+	TCDm.SADDR           = DMA_TCD_SADDR_SADDR((uint32_t) source);		/* First result of the scan */
+	TCDm.SOFF            = DMA_TCD_SOFF_SOFF(4);						/* Next result register */
+	TCDm.ATTR            = DMA_TCD_ATTR_SMOD(smod) |					/* Src. wraps over the results of the scan */
+						   DMA_TCD_ATTR_SIZE(2, 2);						/* Src./Dest. 32 bits per transfer */
+	TCDm.NBYTES_MLOFFYES = DMA_TCD_NBYTES_MLOFFYES_NBYTES(4u * channels) |	/* One result per slot each minor loop */
+						   DMA_TCD_NBYTES_MLOFFYES_DMLOE(1)  |			/* Minor loop offset applied to dest. */
+						   DMA_TCD_NBYTES_MLOFFYES_SMLOE(0)  |			/* Src. handled by the modulo */
+						   DMA_TCD_NBYTES_MLOFFYES_MLOFF(4 - (4 * (int32_t) channels * depth));	/* Back to the next sample of the first array */
+	TCDm.SLAST           = 0;											/* Src. already back to the first result */
+	TCDm.DADDR           = DMA_TCD_DADDR_DADDR((uint32_t) dest);
+	TCDm.DOFF            = DMA_TCD_DOFF_DOFF(4u * depth);				/* Same sample of the next slot array */
+	TCDm.CITER_ELINKNO   = DMA_TCD_ITER(depth);							/* One minor loop per scan */
+	TCDm.DLASTSGA        = DMA_TCD_DLASTSGA_DLASTSGA(-(4 * (int32_t) depth));	/* Back to dest[0][0] after major loop */
+	TCDm.CSR             = DMA_TCD_CSR_INTMAJOR(1);						/* IRQ when the arrays are full, keep chan active */
+	TCDm.BITER_ELINKNO   = DMA_TCD_ITER(depth);
+
+	DMA_TCD_Load(ch, &TCDm);
+}
+
+/*!
+ * DMA ADC sequence Feature
+ * ===================================================
+ * Set up a scan of any length without CPU: the ADC runs in SW trigger mode
+ * with DMA requests (ADC_Sequence_Config), so writing SC1A starts the next
+ * conversion. On each COCO, DMA_SEQ_RESULT_CH moves R[0] to the results and
+ * links to DMA_SEQ_COMMAND_CH, which writes the next command into SC1A.
+ * Both channels wrap at the end of the sequence, so it runs continuously,
+ * conversion after conversion, until DMA_Sequence_stop.
+ * Each channel of the list is converted "oversampling" times in a row and its
+ * results are kept together (DMA_Sequence_buffer), the list can be longer
+ * than the SC1 slots (up to 511 conversions per sequence).
+ *
+ * @param[DMA_Sequence_t * seq] Sequence handler
+ * @param[const uint8_t * channels] ADCH of each channel of the list
+ * @param[const uint8_t * oversampling] Conversions of each channel per sequence (at least 1)
+ * @param[uint8_t count] Channels of the list
+ * @param[uint32_t * commands] Array of sum(oversampling) words, filled here
+ * @param[uint32_t volatile * results] Array of sum(oversampling) words
+ *
+ */
+void DMA_Sequence_Config(DMA_Sequence_t * seq, const uint8_t * channels, const uint8_t * oversampling, uint8_t count, uint32_t * commands, uint32_t volatile * results)
+{
+	uint8_t index;
+	uint8_t sample;
+
+	seq->oversampling = oversampling;
+	seq->count        = count;
+	seq->commands     = commands;
+	seq->results      = results;
+	seq->size         = 0;
+
+	for (index = 0; index < count; index++) {
+		for (sample = 0; sample < oversampling[index]; sample++) {
+			commands[seq->size++] = ADC_SC1_ADCH(channels[index]);	/* AIEN = 0, conversion complete goes to the DMA */
+		}
+	}
+	DEV_ASSERT((seq->size > 0u) && (seq->size <= 0x1FFu));		/* CITER with minor loop linking */
+
+	DMA_Channel_reserve(DMA_SEQ_RESULT_CH, EDMA_REQ_ADC0, DMA_PRIO_CRITICAL);		/* ADC0 COCO requests */
+	DMA_Channel_reserve(DMA_SEQ_COMMAND_CH, EDMA_REQ_DISABLED, DMA_PRIO_CRITICAL);	/* Only started by links */
+}
+
+/*!
+ * DMA ADC sequence start
+ * ===================================================
+ * Load both channels at the start of the sequence and write the first
+ * command into SC1A with a software request of DMA_SEQ_COMMAND_CH.
+ *
+ * @param[DMA_Sequence_t * seq] Sequence handler
+ *
+ */
+void DMA_Sequence_start(DMA_Sequence_t * seq)
+{
+	TCD_t TCDm = DMA_TCD_IMAGE(&(ADC0->R[0]),			/* Source Address to ADC0 Result Register */
+							   0,						/* Stay the same source address after Transfers */
+							   seq->results,			/* Destination Address to the results */
+							   4,						/* Dest. adr add 4 bytes after transfers */
+							   DMA_TCD_ATTR_SIZE(2, 2),	/* Src./Dest. 32 bits per transfer, no modulo */
+							   4,						/* Transfer 4 byte /minor loop */
+							   0,						/* No Source Address change after major loop */
+							   -(4 * (int32_t) seq->size),	/* Back to the first result after major loop */
+							   DMA_TCD_ITER_LINK(seq->size, DMA_SEQ_COMMAND_CH),	/* One minor loop per conversion, link to next command */
+							   DMA_TCD_CSR_MAJORELINK(1) |	/* The last result also starts the next sequence */
+							   DMA_TCD_CSR_MAJORLINKCH(DMA_SEQ_COMMAND_CH));	/* Keep chan active after major loop */
+
+	DMA_TCD_Load(DMA_SEQ_RESULT_CH, &TCDm);
+
+	TCDm = (TCD_t) DMA_TCD_IMAGE(seq->commands,			/* Source Address to the commands */
+								 4,						/* Src. addr add 4 byte after Transfers */
+								 &(ADC0->SC1[0]),		/* Destination Address to ADC SC1_A register */
+								 0,						/* No destination change after transfer */
+								 DMA_TCD_ATTR_SIZE(2, 2),	/* Src./Dest. 32 bits per transfer, no modulo */
+								 4,						/* Transfers 4 byte /minor loop */
+								 -(4 * (int32_t) seq->size),	/* Back to the first command after major loop */
+								 0,						/* No dest. change after major loop */
+								 DMA_TCD_ITER(seq->size),	/* One minor loop per conversion */
+								 0);					/* Keep chan active, no IRQ */
+
+	DMA_TCD_Load(DMA_SEQ_COMMAND_CH, &TCDm);
+
+	DMA->SERQ = DMA_SERQ_SERQ(DMA_SEQ_RESULT_CH);		/* Accept ADC0 COCO requests */
+	DMA->SSRT = DMA_SSRT_SSRT(DMA_SEQ_COMMAND_CH);		/* First command, starts the sequence */
+}
+
+/*!
+ * DMA ADC sequence stop
+ * ===================================================
+ * The pending COCO request is not served any more and the conversion in
+ * progress is aborted. DMA_Sequence_start starts again from the beginning.
+ */
+void DMA_Sequence_stop(void)
+{
+	DMA->CERQ = DMA_CERQ_CERQ(DMA_SEQ_RESULT_CH);	/* Ignore ADC0 COCO requests */
+	ADC0->SC1[0] = ADC_SC1_ADCH_MASK;				/* ADCH = 1F Module is disabled for conversions */
+}
+
+/*!
+ * DMA ADC sequence channel buffer
+ * ===================================================
+ * @param[const DMA_Sequence_t * seq] Sequence handler
+ * @param[uint8_t index] Channel of the list
+ *
+ * @return First of the oversampling[index] results of the channel
+ */
+uint32_t volatile * DMA_Sequence_buffer(const DMA_Sequence_t * seq, uint8_t index)
+{
+	uint32_t volatile * buffer = seq->results;
+	uint8_t i;
+
+	for (i = 0; i < index; i++) {
+		buffer += seq->oversampling[i];
+	}
+	return buffer;
+}
+
+/*!
+ * DMA ADC sequence channel average
+ * ===================================================
+ * Average of the results of one channel. The results are written by the DMA
+ * while they are read, so they may come from two consecutive sequences.
+ *
+ * @param[const DMA_Sequence_t * seq] Sequence handler
+ * @param[uint8_t index] Channel of the list
+ *
+ * @return Average of the oversampling[index] results of the channel
+ */
+uint16_t DMA_Sequence_average(const DMA_Sequence_t * seq, uint8_t index)
+{
+	uint32_t volatile * buffer = DMA_Sequence_buffer(seq, index);
+	uint32_t sum = 0;
+	uint8_t i;
+
+	for (i = 0; i < seq->oversampling[index]; i++) {
+		sum += buffer[i];
+	}
+	return (uint16_t) (sum / seq->oversampling[index]);
+}
+
+/*!
+ * DMA channel link program initialization
+ * ===================================================
+ * A program is a list of steps (register writes or data moves) executed by
+ * a single channel every time it gets a request (DMAMUX source, link from
+ * another channel or DMA_Program_run). Each step is a TCD with a single
+ * minor loop that loads the next step through Scatter Gather and links to
+ * its own channel, so the next step starts right away; the last step loads
+ * the first one again and waits for the next request. This way sequences
+ * like "switch ADC channel, update PDB delay, kick a CAN mailbox" run with
+ * the core asleep.
+ *
+ * @param[DMA_Program_t * prog] Program handler
+ * @param[uint8_t ch] DMA channel that will execute the program
+ * @param[TCD_t * TCDm] Array of TCDs aligned to 32 bytes, one per step
+ * @param[uint8_t size] Amount of TCDs inside the array
+ *
+ */
+void DMA_Program_init(DMA_Program_t * prog, uint8_t ch, TCD_t * TCDm, uint8_t size)
+{
+	DEV_ASSERT(ch < DMA_TCD_COUNT);
+	DEV_ASSERT(((uint32_t) TCDm & 0x1Fu) == 0u);	/* ESG requires 32-byte aligned TCDs */
+
+	prog->TCDm  = TCDm;
+	prog->size  = size;
+	prog->steps = 0;
+	prog->ch    = ch;
+}
+
+/*!
+ * DMA channel link program: data move step
+ * ===================================================
+ * Add a step that copies count elements of 2**width bytes from source to
+ * dest (both addresses incremented). The data is read when the step runs.
+ *
+ * @param[DMA_Program_t * prog] Program handler
+ * @param[void volatile * dest] Destination Address (memory or peripheral register)
+ * @param[void const volatile * source] Source Address
+ * @param[uint8_t width] Transfer size: 0 = 8 bits, 1 = 16 bits, 2 = 32 bits
+ * @param[uint16_t count] Amount of elements to copy
+ *
+ */
+void DMA_Program_move(DMA_Program_t * prog, void volatile * dest, void const volatile * source, uint8_t width, uint16_t count)
+{
+	TCD_t * TCDm = &prog->TCDm[prog->steps];
+
+	DEV_ASSERT(prog->steps < prog->size);
+	DEV_ASSERT((width <= 2u) && (count > 0u));
+
+	TCDm->SADDR          = DMA_TCD_SADDR_SADDR((uint32_t) source);
+	TCDm->SOFF           = DMA_TCD_SOFF_SOFF(1u << width);
+	TCDm->ATTR           = DMA_TCD_ATTR_SIZE(width, width);
+	TCDm->NBYTES_MLNO    = DMA_TCD_NBYTES_MLNO_NBYTES((uint32_t) count << width);	/* Whole step in one minor loop */
+	TCDm->SLAST          = 0;							/* Addresses are reloaded by the next step */
+	TCDm->DADDR          = DMA_TCD_DADDR_DADDR((uint32_t) dest);
+	TCDm->DOFF           = DMA_TCD_DOFF_DOFF(1u << width);
+	TCDm->CITER_ELINKNO  = DMA_TCD_ITER(1);				/* One minor loop per step */
+	TCDm->BITER_ELINKNO  = DMA_TCD_ITER(1);
+	TCDm->DLASTSGA       = 0;							/* Set by DMA_Program_load */
+	TCDm->CSR            = 0;
+
+	prog->steps++;
+}
+
+/*!
+ * DMA channel link program: register write step
+ * ===================================================
+ * Add a step that writes the 32-bit word pointed by value into reg. value
+ * must stay valid while the program is in use (e.g. a const in flash or a
+ * variable the application updates between runs).
+ */
+void DMA_Program_write(DMA_Program_t * prog, uint32_t volatile * reg, uint32_t const * value)
+{
+	DMA_Program_move(prog, reg, value, 2, 1);
+}
+
+/*!
+ * DMA channel link program load
+ * ===================================================
+ * Chain the steps (ESG to the next step plus a major link to the own channel),
+ * make the last step load the first one and stop, then load the first step
+ * into the channel. Requests of the channel are not enabled here.
+ */
+void DMA_Program_load(DMA_Program_t * prog)
+{
+	uint8_t step;
+	uint8_t next;
+
+	DEV_ASSERT(prog->steps > 0u);
+
+	for (step = 0; step < prog->steps; step++) {
+		next = (uint8_t)((step + 1u) % prog->steps);
+		prog->TCDm[step].DLASTSGA = DMA_TCD_DLASTSGA_DLASTSGA(&prog->TCDm[next]);	/* Next step */
+		prog->TCDm[step].CSR      = DMA_TCD_CSR_ESG(1);							/* Load the next step after this one */
+		if (next != 0u) {
+			prog->TCDm[step].CSR |= DMA_TCD_CSR_MAJORELINK(1) |					/* Start it right away */
+									DMA_TCD_CSR_MAJORLINKCH(prog->ch);
+		}
+	}
+
+	DMA_TCD_Push(prog->ch, &prog->TCDm[0]);	/* "Push" first step */
+}
+
+/*!
+ * DMA channel link program run: start the program by software.
+ */
+void DMA_Program_run(DMA_Program_t * prog)
+{
+	DMA_INSTR_START(prog->ch);
+	DMA->SSRT = DMA_SSRT_SSRT(prog->ch);	/* Set the START bit of the program channel */
+}
+
+/*!
+ * Scatter Gather ring initialization
+ * ===================================================
+ * Bind a caller supplied array of TCDs to a DMA channel. Each entry of the
+ * array describes one block of the stream and links to the next one through
+ * DLASTSGA, the last entry links back to the first one, so once started the
+ * eDMA keeps loading the next TCD by itself without any CPU intervention.
+ *
+ * @param[DMA_Ring_t * ring] Ring handler to initialize
+ * @param[uint8_t ch] DMA channel that will execute the ring
+ * @param[TCD_t * TCDm] Array of TCDs aligned to 32 bytes (required by the Scatter Gather feature)
+ * @param[uint8_t size] Amount of TCDs inside the array
+ *
+ */
+void DMA_Ring_init(DMA_Ring_t * ring, uint8_t ch, TCD_t * TCDm, uint8_t size)
+{
+	DEV_ASSERT(ch < DMA_TCD_COUNT);
+	DEV_ASSERT(size > 0u);
+	DEV_ASSERT(((uint32_t) TCDm & 0x1Fu) == 0u);	/* ESG requires 32-byte aligned TCDs */
+
+	ring->TCDm   = TCDm;
+	ring->size   = size;
+	ring->ch     = ch;
+	ring->head   = 0;
+	ring->blocks = 0;
+}
+
+/*!
+ * Scatter Gather ring block configuration
+ * ===================================================
+ * Save the configuration of one block of the ring using DMA_TCDm_config and
+ * turn it into a ring element: the channel is kept enabled after the major
+ * loop (DREQ = 0) and the Scatter Gather address points to the next TCD.
+ *
+ * @param[DMA_Ring_t * ring] Ring handler
+ * @param[uint8_t index] Position of the block inside the ring
+ * @param[uint32_t * buff_source] Pointer to the direction Source Address
+ * @param[uint8_t SOFF] Amount of bytes added to Source Address after transfer
+ * @param[uint32_t * buff_dest] Pointer to the direction Destination Address
+ * @param[uint8_t DOFF] Amount of bytes added to Direction Address after transfer
+ * @param[uint32_t size] Amount of Minor loops required
+ *
+ */
+void DMA_Ring_block_config(DMA_Ring_t * ring, uint8_t index, uint32_t * buff_source, uint8_t SOFF, uint32_t * buff_dest, uint8_t DOFF, uint32_t size)
+{
+	TCD_t * TCDm = &ring->TCDm[index];
+	uint8_t next = (uint8_t)((index + 1u) % ring->size);
+
+	DEV_ASSERT(index < ring->size);
+
+	DMA_TCDm_config(buff_source, SOFF, buff_dest, DOFF, size, TCDm);
+	TCDm->CSR &= ~(DMA_TCD_CSR_DREQ(1));	/* DREQ = 0: Keep DMA CH active after major loop */
+	TCDm->CSR |= DMA_TCD_CSR_ESG(1);		/* ESG = 1: Enable Scatter Gather feature	*/
+	TCDm->DLASTSGA = DMA_TCD_DLASTSGA_DLASTSGA(&ring->TCDm[next]);	/* Next block of the ring */
+}
+
+/*!
+ * Scatter Gather ring start
+ * ===================================================
+ * Load the first block of the ring into the channel and enable its requests.
+ * From here on the blocks are fetched by the eDMA in a loop.
+ */
+void DMA_Ring_start(DMA_Ring_t * ring)
+{
+	ring->head   = 0;
+	ring->blocks = 0;
+
+	DMA->CERQ = DMA_CERQ_CERQ(ring->ch);	/* Stop requests while the TCD is loaded */
+	DMA_TCD_Push(ring->ch, &ring->TCDm[0]);	/* "Push" first block of the ring */
+	DMA_INSTR_START(ring->ch);
+	DMA->SERQ = DMA_SERQ_SERQ(ring->ch);	/* Enable requests of the ring channel */
+}
+
+/*!
+ * Scatter Gather ring stop
+ * ===================================================
+ * Disable the requests of the ring channel, the block in progress is left
+ * unfinished.
+ */
+void DMA_Ring_stop(DMA_Ring_t * ring)
+{
+	DMA->CERQ = DMA_CERQ_CERQ(ring->ch);	/* Disable requests of the ring channel */
+}
+
+/*!
+ * Scatter Gather ring block completion
+ * ===================================================
+ * To be called from the DMA interrupt of the ring channel (every block is
+ * configured with INTMAJOR). Clears the interrupt request and advances the
+ * head of the ring.
+ *
+ * @return Index of the block that has just been filled, so the application
+ *         can process it while the eDMA works on the following ones.
+ */
+uint8_t DMA_Ring_block_done(DMA_Ring_t * ring)
+{
+	uint8_t done = ring->head;
+
+	DMA->CINT = DMA_CINT_CINT(ring->ch);	/* Clear Interrupt request of the ring channel */
+	ring->head = (uint8_t)((done + 1u) % ring->size);
+	ring->blocks++;
+
+	return done;
+}
+
+static uint8_t DMA_memcpy_ch = DMA_CH_NONE;	/*< Channel allocated by DMA_memcpy_init */
+static uint32_t volatile DMA_memset_pattern[4] __attribute__ ((aligned(16)));	/*< Source of DMA_memset (one 16-byte burst) */
+
+/*!
+ * Transfer size selection
+ * ===================================================
+ * Returns the widest ATTR SSIZE/DSIZE encoding allowed by the alignment of
+ * the address: 4 (16-byte burst), 2 (32 bits), 1 (16 bits) or 0 (8 bits).
+ */
+static uint8_t DMA_size_select(uint32_t address)
+{
+	uint8_t size;
+
+	if ((address & 0xFu) == 0u) {
+		size = 4;
+	}
+	else if ((address & 0x3u) == 0u) {
+		size = 2;
+	}
+	else if ((address & 0x1u) == 0u) {
+		size = 1;
+	}
+	else {
+		size = 0;
+	}
+	return size;
 }
 
+/*!
+ * Start a memory to memory transfer
+ * ===================================================
+ * The buffer is split in an unaligned head, a body moved by the eDMA with
+ * the widest transfer size both addresses allow and a tail. Head and tail
+ * are copied by the CPU while the eDMA moves the body, so the function
+ * returns as soon as the transfer is started.
+ *
+ * @param[uint8_t * dest] Destination Address
+ * @param[const uint8_t * source] Source Address
+ * @param[uint16_t SOFF] Source offset per read (0 for DMA_memset)
+ * @param[uint8_t ssize_max] Widest source size allowed (source alignment of the pattern for DMA_memset)
+ * @param[uint32_t count] Amount of bytes to be written
+ *
+ */
+static void DMA_memcpy_start(uint8_t * dest, const uint8_t * source, uint16_t SOFF, uint8_t ssize_max, uint32_t count)
+{
+	TCD_t TCDm;
+	uint32_t head;
+	uint32_t body;
+	uint32_t nbytes;
+	uint8_t ssize;
+	uint8_t dsize;
+
+	/* Head: CPU writes bytes until the destination is word aligned */
+	head = (4u - ((uint32_t) dest & 0x3u)) & 0x3u;
+	count -= head;
+	while (head-- > 0u) {
+		*dest++ = *source;
+		source += SOFF ? 1u : 0u;
+	}
+
+	/* Body: widest transfer sizes allowed by source and destination alignment */
+	ssize = (SOFF != 0u) ? DMA_size_select((uint32_t) source) : ssize_max;
+	dsize = DMA_size_select((uint32_t) dest);
+	if (ssize > ssize_max) {
+		ssize = ssize_max;
+	}
+	nbytes = 1u << ((ssize > dsize) ? ssize : dsize);	/* Minor loop: one transfer of the widest side */
+	while ((count / nbytes) > 0x7FFFu) {
+		nbytes <<= 1;		/* Keep CITER inside its 15 bits */
+	}
+	body = count - (count % nbytes);
+
+	if (body > 0u) {
+		TCDm.SADDR          = DMA_TCD_SADDR_SADDR((uint32_t) source);
+		TCDm.SOFF           = (SOFF != 0u) ? DMA_TCD_SOFF_SOFF(1u << ssize) : 0u;	/* Src. addr add one transfer after each read */
+		TCDm.ATTR           = DMA_TCD_ATTR_SIZE(ssize, dsize);
+		TCDm.NBYTES_MLNO    = DMA_TCD_NBYTES_MLNO_NBYTES(nbytes);
+		TCDm.SLAST          = 0;
+		TCDm.DADDR          = DMA_TCD_DADDR_DADDR((uint32_t) dest);
+		TCDm.DOFF           = DMA_TCD_DOFF_DOFF(1u << dsize);
+		TCDm.CITER_ELINKNO  = DMA_TCD_ITER(body / nbytes);
+		TCDm.DLASTSGA       = 0;
+		TCDm.CSR            = DMA_TCD_CSR_DREQ(1);	/* Disable chan after major loop */
+		TCDm.BITER_ELINKNO  = DMA_TCD_ITER(body / nbytes);
+
+		DMA_TCD_Load(DMA_memcpy_ch, &TCDm);
+		DMA->SERQ = DMA_SERQ_SERQ(DMA_memcpy_ch);	/* Always enabled source: runs the whole major loop */
+	}
+
+	/* Tail: CPU copies the remaining bytes while the eDMA works on the body */
+	dest += body;
+	source += SOFF ? body : 0u;
+	count -= body;
+	while (count-- > 0u) {
+		*dest++ = *source;
+		source += SOFF ? 1u : 0u;
+	}
+}
+
+/*!
+ * DMA memcpy initialization
+ * ===================================================
+ * Allocate a bulk priority channel with an always enabled request, so once
+ * its request is enabled the major loop is executed without further
+ * triggers and latency critical channels can preempt it. Call it after the
+ * fixed channels of the application have been reserved.
+ */
+void DMA_memcpy_init(void)
+{
+	DMA_memcpy_ch = DMA_Channel_alloc(EDMA_REQ_DMAMUX_ALWAYS_ENABLED1, DMA_PRIO_BULK);
+	DEV_ASSERT(DMA_memcpy_ch != DMA_CH_NONE);
+}
+
+/*!
+ * DMA memcpy
+ * ===================================================
+ * Copy count bytes from source to dest. Short copies (or every copy until
+ * DMA_memcpy_init has allocated a channel) are done by the CPU, longer ones
+ * are moved by the eDMA and the function returns while the transfer is in
+ * progress; use DMA_memcpy_busy/DMA_memcpy_wait before using the
+ * destination.
+ *
+ * @param[void * dest] Destination Address
+ * @param[const void * source] Source Address
+ * @param[uint32_t count] Amount of bytes to copy
+ *
+ */
+void DMA_memcpy(void * dest, const void * source, uint32_t count)
+{
+	uint8_t * d = (uint8_t *) dest;
+	const uint8_t * s = (const uint8_t *) source;
+
+	DMA_memcpy_wait();		/* Only one transfer in flight */
+
+	if ((count < DMA_MEMCPY_THRESHOLD) || (DMA_memcpy_ch == DMA_CH_NONE)) {
+		while (count-- > 0u) {
+			*d++ = *s++;
+		}
+	}
+	else {
+		DMA_memcpy_start(d, s, 1, 4, count);
+	}
+}
+
+/*!
+ * DMA memset
+ * ===================================================
+ * Fill count bytes of dest with value. The eDMA reads the pattern from a
+ * 16-byte aligned buffer without incrementing the source address.
+ *
+ * @param[void * dest] Destination Address
+ * @param[uint8_t value] Value to write
+ * @param[uint32_t count] Amount of bytes to fill
+ *
+ */
+void DMA_memset(void * dest, uint8_t value, uint32_t count)
+{
+	uint8_t * d = (uint8_t *) dest;
+	uint32_t pattern = 0x01010101u * value;
+
+	DMA_memcpy_wait();		/* The pattern is in use until the previous transfer ends */
 
+	if ((count < DMA_MEMCPY_THRESHOLD) || (DMA_memcpy_ch == DMA_CH_NONE)) {
+		while (count-- > 0u) {
+			*d++ = value;
+		}
+	}
+	else {
+		DMA_memset_pattern[0] = pattern;
+		DMA_memset_pattern[1] = pattern;
+		DMA_memset_pattern[2] = pattern;
+		DMA_memset_pattern[3] = pattern;
+		DMA_memcpy_start(d, (const uint8_t *) DMA_memset_pattern, 0, 4, count);
+	}
+}
+
+/*!
+ * Returns 1 while a DMA_memcpy / DMA_memset transfer is in progress.
+ */
+uint8_t DMA_memcpy_busy(void)
+{
+	if (DMA_memcpy_ch == DMA_CH_NONE) {
+		return 0;		/* DMA_memcpy_init not called: every copy is done by the CPU */
+	}
+	return (((DMA->ERQ >> DMA_memcpy_ch) & 1u) |									/* Request still enabled (DREQ clears it at the end) */
+			((DMA->TCD[DMA_memcpy_ch].CSR >> DMA_TCD_CSR_ACTIVE_SHIFT) & 1u)) ? 1u : 0u;	/* or last minor loop still active */
+}
+
+/*!
+ * Wait until the DMA_memcpy / DMA_memset transfer in progress has ended.
+ */
+void DMA_memcpy_wait(void)
+{
+	while (DMA_memcpy_busy()) {}
+}
+
+#ifdef DMA_INSTRUMENTATION
+DMA_Instr_t volatile DMA_Instr;		/*< Debug hook: completions, latencies and last error of the DMA */
+
+/*!
+ * DMA instrumentation initialization
+ * ===================================================
+ * Clear the collected data, start LPIT0 channel DMA_INSTR_LPIT_CH as a free
+ * running 32-bit counter used for timestamps and enable the error
+ * interrupts of the instrumented channels only, so errors of the other
+ * channels stay with their own drivers (DMA_Error_IRQHandler must call
+ * DMA_Instr_error).
+ *
+ * @param[uint8_t channels] Mask of the instrumented channels (bit n = channel n)
+ *
+ */
+void DMA_Instr_init(uint8_t channels)
+{
+	uint8_t ch;
+
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		DMA_Instr.ch[ch].completions = 0;
+		DMA_Instr.ch[ch].start       = 0;
+		DMA_Instr.ch[ch].latency     = 0;
+		DMA_Instr.ch[ch].latency_max = 0;
+	}
+	DMA_Instr.error.count = 0;
+	DMA_Instr.error.ES    = 0;
+
+	if ((PCC->PCCn[PCC_LPIT_INDEX] & PCC_PCCn_CGC_MASK) == 0u) {
+		PCC->PCCn[PCC_LPIT_INDEX] = PCC_PCCn_PCS(2);		/* Clock Source = 2 (SIRCDIV2_CLK = 8 MHz) */
+		PCC->PCCn[PCC_LPIT_INDEX] |= PCC_PCCn_CGC_MASK;		/* Enable CLK for LPIT registers */
+	}
+	LPIT0->MCR |= LPIT_MCR_M_CEN_MASK;						/* M_CEN = 1: Enable module clock */
+	LPIT0->TMR[DMA_INSTR_LPIT_CH].TVAL = 0xFFFFFFFFu;		/* Longest period, the counter wraps freely */
+	LPIT0->TMR[DMA_INSTR_LPIT_CH].TCTRL = LPIT_TMR_TCTRL_T_EN_MASK;	/* MODE = 0: 32 Periodic counter, no interrupt */
+
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		if ((channels & (1u << ch)) != 0u) {
+			DMA->SEEI = DMA_SEEI_SEEI(ch);	/* Enable error interrupt of the instrumented channel */
+		}
+	}
+}
+
+/*!
+ * Current timestamp in LPIT ticks (the LPIT counts down, it is inverted).
+ */
+uint32_t DMA_Instr_timestamp(void)
+{
+	return ~LPIT0->TMR[DMA_INSTR_LPIT_CH].CVAL;
+}
+
+/*!
+ * Record the start of a transfer of a channel.
+ */
+void DMA_Instr_start(uint8_t ch)
+{
+	DMA_Instr.ch[ch].start = DMA_Instr_timestamp();
+}
+
+/*!
+ * Record a major loop completion, to be called from the channel interrupt.
+ * The latency is measured from DMA_Instr_start or, for channels that keep
+ * running (rings, ping-pong buffers), from the previous completion, so a
+ * latency growing over the expected period shows a starved pipeline.
+ */
+void DMA_Instr_done(uint8_t ch)
+{
+	uint32_t now = DMA_Instr_timestamp();
+	uint32_t latency = now - DMA_Instr.ch[ch].start;
+
+	DMA_Instr.ch[ch].completions++;
+	DMA_Instr.ch[ch].latency = latency;
+	if (latency > DMA_Instr.ch[ch].latency_max) {
+		DMA_Instr.ch[ch].latency_max = latency;
+	}
+	DMA_Instr.ch[ch].start = now;
+}
+
+/*!
+ * Decode DMA->ES, to be called from DMA_Error_IRQHandler. The error flag of
+ * the channel is cleared.
+ */
+void DMA_Instr_error(void)
+{
+	uint32_t es = DMA->ES;
+	DMA_Error_t volatile * error = &DMA_Instr.error;
+
+	error->count++;
+	error->ES             = es;
+	error->channel        = (uint8_t)((es & DMA_ES_ERRCHN_MASK) >> DMA_ES_ERRCHN_SHIFT);
+	error->source_bus     = (es & DMA_ES_SBE_MASK) ? 1u : 0u;
+	error->dest_bus       = (es & DMA_ES_DBE_MASK) ? 1u : 0u;
+	error->scatter_gather = (es & DMA_ES_SGE_MASK) ? 1u : 0u;
+	error->nbytes_citer   = (es & DMA_ES_NCE_MASK) ? 1u : 0u;
+	error->dest_offset    = (es & DMA_ES_DOE_MASK) ? 1u : 0u;
+	error->dest_address   = (es & DMA_ES_DAE_MASK) ? 1u : 0u;
+	error->source_offset  = (es & DMA_ES_SOE_MASK) ? 1u : 0u;
+	error->source_address = (es & DMA_ES_SAE_MASK) ? 1u : 0u;
+	error->priority       = (es & DMA_ES_CPE_MASK) ? 1u : 0u;
+	error->cancelled      = (es & DMA_ES_ECX_MASK) ? 1u : 0u;
+
+	DMA->CERR = DMA_CERR_CERR(error->channel);	/* Clear the error of the channel */
+}
+
+/*!
+ * Access to the collected data (also visible as DMA_Instr from a debugger).
+ */
+const DMA_Instr_t * DMA_Instr_get(void)
+{
+	return (const DMA_Instr_t *) &DMA_Instr;
+}
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "device_registers.h"								/* include peripheral declarations */
+#include "LPIT.h"
+
+/*!
+* @brief LPIT0 Initialization as a free running 64-bit timestamp: channel
+* LPIT_TIMESTAMP_CH counts SIRCDIV2 clocks and the next channel, in chain
+* mode, counts its timeouts. At 8 MHz it wraps after 73000 years.
+*/
+void LPIT0_timestamp_init (void)
+{
+	/* Module Configuration */
+	if ((PCC -> PCCn[PCC_LPIT_INDEX] & PCC_PCCn_CGC_MASK) == 0u)	/* The LPIT may already be in use */
+	{
+		PCC -> PCCn[PCC_LPIT_INDEX] = PCC_PCCn_PCS(2);    	/* Clock Source = 2 (SIRCDIV2_CLK = 8 MHz) */
+		PCC -> PCCn[PCC_LPIT_INDEX] |= PCC_PCCn_CGC_MASK; 	/* Enable CLK for LPIT registers */
+	}
+
+	LPIT0 -> MCR |= LPIT_MCR_M_CEN_MASK;  					/* M_CEN = 1: Enable module clock (allows writing other LPIT0 registers) */
+
+	/* High word: decremented on each timeout of the low word */
+	LPIT0 -> TMR[LPIT_TIMESTAMP_CH + 1].TVAL = 0xFFFFFFFFu;
+	LPIT0 -> TMR[LPIT_TIMESTAMP_CH + 1].TCTRL = LPIT_TMR_TCTRL_CHAIN_MASK		/* CHAIN = 1: Channel chaining is enabled */
+											  | LPIT_TMR_TCTRL_T_EN_MASK;		/* T_EN = 1: Timer channel is enabled, no interrupt */
+
+	/* Low word: 2^32 clocks per timeout */
+	LPIT0 -> TMR[LPIT_TIMESTAMP_CH].TVAL = 0xFFFFFFFFu;
+	LPIT0 -> TMR[LPIT_TIMESTAMP_CH].TCTRL = LPIT_TMR_TCTRL_T_EN_MASK;		/* T_EN = 1, MODE = 0: 32 Periodic counter mode */
+}
+
+/*!
+* @brief Current timestamp in SIRCDIV2 clocks since LPIT0_timestamp_init.
+* The channels count down, so the counters are inverted. The high word is
+* read again in case the low word wrapped between the two reads.
+*
+* @return 64-bit timestamp.
+*/
+uint64_t LPIT0_timestamp (void)
+{
+	uint32_t high;
+	uint32_t low;
+
+	do
+	{
+		high = LPIT0 -> TMR[LPIT_TIMESTAMP_CH + 1].CVAL;
+		low  = LPIT0 -> TMR[LPIT_TIMESTAMP_CH].CVAL;
+	} while (high != LPIT0 -> TMR[LPIT_TIMESTAMP_CH + 1].CVAL);
+
+	return ((uint64_t) ~high << 32) | (uint64_t) ~low;
+}
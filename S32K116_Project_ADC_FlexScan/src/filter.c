@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "filter.h"
+
+/*!
+ * Decimator initialization
+ * ===================================================
+ * @param[FILTER_Decimator_t * dec] Decimator state
+ * @param[FILTER_Type_t type] Moving average or CIC
+ * @param[uint8_t order] CIC stages (1 to FILTER_CIC_ORDER_MAX), ignored by the moving average
+ * @param[uint8_t ratio_shift] Decimation ratio = 2^ratio_shift
+ * @param[uint8_t extra_bits] Bits of the output above FILTER_INPUT_BITS (up to 4, output fits in 16 bits)
+ *
+ */
+void FILTER_Decimator_init(FILTER_Decimator_t * dec, FILTER_Type_t type, uint8_t order, uint8_t ratio_shift, uint8_t extra_bits)
+{
+	uint8_t k;
+
+	if (type == FILTER_MOVING_AVERAGE) {
+		order = 1;
+	}
+
+	DEV_ASSERT((order >= 1u) && (order <= FILTER_CIC_ORDER_MAX));
+	DEV_ASSERT((ratio_shift <= 15u) && ((FILTER_INPUT_BITS + order * ratio_shift) <= 32u));	/* Register growth of the integrators */
+	DEV_ASSERT((extra_bits <= (order * ratio_shift)) && ((FILTER_INPUT_BITS + extra_bits) <= 16u));
+
+	dec->type        = type;
+	dec->order       = order;
+	dec->ratio_shift = ratio_shift;
+	dec->out_shift   = (uint8_t)(order * ratio_shift - extra_bits);
+	dec->phase       = 0;
+
+	for (k = 0; k < FILTER_CIC_ORDER_MAX; k++) {
+		dec->integrator[k] = 0;
+		dec->comb[k] = 0;
+	}
+}
+
+/*!
+ * Decimator stage
+ * ===================================================
+ * Feed a block of raw results, e.g. the half of a DMA stream buffer just
+ * filled (DMA_Half_callback_t). Results of interleaved channels are picked
+ * with stride: pass &samples[channel] and the amount of channels. The state
+ * is kept between calls, so the block size does not need to be a multiple of
+ * the ratio.
+ *
+ * @param[FILTER_Decimator_t * dec] Decimator state
+ * @param[const uint32_t volatile * samples] First raw result of the channel
+ * @param[uint16_t count] Raw results of the channel in the block
+ * @param[uint8_t stride] Distance between two results of the channel
+ * @param[uint16_t * out] Decimated results, room for count / ratio + 1
+ *
+ * @return Amount of decimated results written to out
+ */
+uint16_t FILTER_Decimator_run(FILTER_Decimator_t * dec, const uint32_t volatile * samples, uint16_t count, uint8_t stride, uint16_t * out)
+{
+	uint16_t ratio = (uint16_t)(1u << dec->ratio_shift);
+	uint16_t written = 0;
+	uint32_t x;
+	uint32_t delayed;
+	uint8_t k;
+
+	while (count-- > 0u) {
+		x = *samples;
+		samples += stride;
+
+		if (dec->type == FILTER_MOVING_AVERAGE) {
+			dec->integrator[0] += x;
+		} else {
+			for (k = 0; k < dec->order; k++) {
+				dec->integrator[k] += x;	/* Wraps, see the comb below */
+				x = dec->integrator[k];
+			}
+		}
+
+		if (++dec->phase < ratio) {
+			continue;
+		}
+		dec->phase = 0;
+
+		if (dec->type == FILTER_MOVING_AVERAGE) {
+			x = dec->integrator[0];
+			dec->integrator[0] = 0;			/* Dump */
+		} else {
+			for (k = 0; k < dec->order; k++) {
+				delayed = dec->comb[k];
+				dec->comb[k] = x;
+				x -= delayed;				/* Modulo 2^32 difference */
+			}
+		}
+
+		out[written++] = (uint16_t)(x >> dec->out_shift);
+	}
+
+	return written;
+}
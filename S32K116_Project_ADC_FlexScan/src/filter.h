@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include "device_registers.h"
+
+/*!
+ * Decimation of ADC results
+ * ===================================================
+ * A decimator takes 2^ratio_shift raw results per output. The sum of those
+ * results grows by order * ratio_shift bits over the 12-bit input; the output
+ * keeps extra_bits of them (oversampling by 4^n gives n more effective bits
+ * when the input has at least 1 LSB of noise). The cost per raw result is one
+ * add per stage whatever the ratio, the rest is done once per output.
+ *
+ * Moving average: the results of each block are summed and dumped (boxcar).
+ * CIC: order integrators at the input rate, order combs at the output rate.
+ * A sharper anti-alias response than the moving average, same cost per input.
+ * The integrators wrap on purpose: two's complement arithmetic makes the comb
+ * outputs exact as long as 12 + order * ratio_shift <= 32.
+ */
+#define FILTER_CIC_ORDER_MAX	3		/* Stages of the CIC decimator */
+#define FILTER_INPUT_BITS		12		/* Resolution of the ADC results */
+
+typedef enum
+{
+	FILTER_MOVING_AVERAGE = 0,		/* Sum and dump of each block of results */
+	FILTER_CIC						/* Cascaded integrator-comb, 1 to FILTER_CIC_ORDER_MAX stages */
+}FILTER_Type_t;
+
+/* State of one decimated stream (one ADC channel). */
+typedef struct
+{
+	FILTER_Type_t type;
+	uint8_t order;						/* Stages, 1 for the moving average */
+	uint8_t ratio_shift;				/* Decimation ratio = 2^ratio_shift raw results per output */
+	uint8_t out_shift;					/* Right shift of the sum: order * ratio_shift - extra_bits */
+	uint16_t phase;						/* Raw results of the current output so far */
+	uint32_t integrator[FILTER_CIC_ORDER_MAX];	/* Running sums at the input rate (the moving average uses [0]) */
+	uint32_t comb[FILTER_CIC_ORDER_MAX];		/* Comb delays at the output rate */
+}FILTER_Decimator_t;
+
+void FILTER_Decimator_init(FILTER_Decimator_t * dec, FILTER_Type_t type, uint8_t order, uint8_t ratio_shift, uint8_t extra_bits);
+uint16_t FILTER_Decimator_run(FILTER_Decimator_t * dec, const uint32_t volatile * samples, uint16_t count, uint8_t stride, uint16_t * out);
+
+#endif /* FILTER_H_ */
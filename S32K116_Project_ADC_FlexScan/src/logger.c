@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "logger.h"
+
+/* Compiler barrier: records are complete in memory before head moves, and read
+ * before tail moves. The Cortex-M0+ is single core and keeps its memory accesses in
+ * program order, so stopping the compiler from moving them is enough. */
+#define LOG_BARRIER()	__asm volatile ("" : : : "memory")
+
+/*!
+ * Ring initialization
+ * ===================================================
+ */
+void LOG_Ring_init(LOG_Ring_t * ring)
+{
+	ring->head    = 0;
+	ring->tail    = 0;
+	ring->dropped = 0;
+}
+
+/*!
+ * Records the producer can still write.
+ */
+uint16_t LOG_Ring_free(const LOG_Ring_t * ring)
+{
+	return (uint16_t)(LOG_RING_SIZE - (uint16_t)(ring->head - ring->tail));
+}
+
+/*!
+ * Producer side: record index (0 to LOG_Ring_free - 1) after the last one
+ * published. It is not visible to the consumer until LOG_Ring_commit.
+ */
+LOG_Record_t * LOG_Ring_record(LOG_Ring_t * ring, uint16_t index)
+{
+	return &ring->records[(uint16_t)(ring->head + index) & (LOG_RING_SIZE - 1u)];
+}
+
+/*!
+ * Producer side: publish count records written with LOG_Ring_record, with
+ * one update of head.
+ */
+void LOG_Ring_commit(LOG_Ring_t * ring, uint16_t count)
+{
+	LOG_BARRIER();	/* Records written before they are published */
+	ring->head = (uint16_t)(ring->head + count);
+}
+
+/*!
+ * Block of DMA results
+ * ===================================================
+ * Producer side: log a block of results taken at a fixed period, e.g. a half
+ * of the FlexScan stream buffer (DMA_Half_callback_t). The last result gets
+ * last_timestamp (read in the DMA completion interrupt), each previous one
+ * is period earlier. Results that do not fit are dropped.
+ *
+ * @param[LOG_Ring_t * ring] Ring
+ * @param[const uint32_t volatile * samples] Raw results, oldest first
+ * @param[uint16_t count] Amount of results
+ * @param[const uint8_t * channels] ADCH of the first channel_count results, repeated along the block
+ * @param[uint8_t channel_count] Entries of channels
+ * @param[uint64_t last_timestamp] Timestamp of samples[count - 1]
+ * @param[uint32_t period] Timestamp clocks between two results
+ *
+ * @return Records logged
+ */
+uint16_t LOG_Ring_push_block(LOG_Ring_t * ring, const uint32_t volatile * samples, uint16_t count, const uint8_t * channels, uint8_t channel_count, uint64_t last_timestamp, uint32_t period)
+{
+	uint16_t room = LOG_Ring_free(ring);
+	uint64_t timestamp = last_timestamp - (uint64_t) period * (count - 1u);
+	LOG_Record_t * record;
+	uint16_t i;
+	uint8_t ch = 0;
+
+	if (count > room) {
+		ring->dropped += (uint32_t)(count - room);
+		count = room;
+	}
+
+	for (i = 0; i < count; i++) {
+		record = LOG_Ring_record(ring, i);
+		record->timestamp = timestamp;
+		record->value     = (uint16_t) samples[i];
+		record->channel   = channels[ch];
+
+		timestamp += period;
+		if (++ch == channel_count) {
+			ch = 0;
+		}
+	}
+
+	LOG_Ring_commit(ring, count);
+
+	return count;
+}
+
+/*!
+ * Consumer side: oldest records not released yet. Only the records up to the
+ * end of the array are returned, the rest comes with the next call.
+ *
+ * @param[const LOG_Ring_t * ring] Ring
+ * @param[const LOG_Record_t ** first] Oldest record
+ *
+ * @return Amount of contiguous records from first
+ */
+uint16_t LOG_Ring_read(const LOG_Ring_t * ring, const LOG_Record_t ** first)
+{
+	uint16_t tail = ring->tail;
+	uint16_t available = (uint16_t)(ring->head - tail);
+	uint16_t index = tail & (LOG_RING_SIZE - 1u);
+
+	if (available > (LOG_RING_SIZE - index)) {
+		available = (uint16_t)(LOG_RING_SIZE - index);	/* Wraps, stop at the end of the array */
+	}
+
+	*first = &ring->records[index];
+	return available;
+}
+
+/*!
+ * Consumer side: free count records returned by LOG_Ring_read, with one
+ * update of tail.
+ */
+void LOG_Ring_release(LOG_Ring_t * ring, uint16_t count)
+{
+	LOG_BARRIER();	/* Records read before the producer may overwrite them */
+	ring->tail = (uint16_t)(ring->tail + count);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef LOGGER_H_
+#define LOGGER_H_
+
+#include "device_registers.h"
+
+/*!
+ * Timestamped sample ring
+ * ===================================================
+ * Single producer (the DMA completion interrupt), single consumer (an
+ * exporter in the main loop). The producer only writes head, the consumer
+ * only writes tail, so no lock nor interrupt masking is needed. Both sides
+ * work on batches: the producer fills several records and publishes them
+ * with LOG_Ring_commit, the consumer gets a contiguous block with
+ * LOG_Ring_read and frees it with LOG_Ring_release. When the ring is full the
+ * new records are dropped and counted, acquisition never waits for a reader.
+ */
+#define LOG_RING_SIZE	64		/* Records of the ring, power of 2 */
+
+/* One ADC result. */
+typedef struct
+{
+	uint64_t timestamp;		/* LPIT0_timestamp clocks at the end of the conversion */
+	uint16_t value;			/* Raw result */
+	uint8_t channel;		/* ADCH of the conversion */
+}LOG_Record_t;
+
+typedef struct
+{
+	LOG_Record_t records[LOG_RING_SIZE];
+	uint16_t volatile head;		/* Records published, free running, written by the producer */
+	uint16_t volatile tail;		/* Records released, free running, written by the consumer */
+	uint32_t volatile dropped;	/* Records lost because the ring was full */
+}LOG_Ring_t;
+
+void LOG_Ring_init(LOG_Ring_t * ring);
+uint16_t LOG_Ring_free(const LOG_Ring_t * ring);
+LOG_Record_t * LOG_Ring_record(LOG_Ring_t * ring, uint16_t index);
+void LOG_Ring_commit(LOG_Ring_t * ring, uint16_t count);
+uint16_t LOG_Ring_push_block(LOG_Ring_t * ring, const uint32_t volatile * samples, uint16_t count, const uint8_t * channels, uint8_t channel_count, uint64_t last_timestamp, uint32_t period);
+uint16_t LOG_Ring_read(const LOG_Ring_t * ring, const LOG_Record_t ** first);
+void LOG_Ring_release(LOG_Ring_t * ring, uint16_t count);
+
+#endif /* LOGGER_H_ */
@@ -37,6 +37,16 @@
  * In this project, PDB triggers ADC0 CH0 measurements which will be saved inside an internal memory buffer through DMA,
  * this way the MCU doesn't need to read the ADC result register because the transfers will be done by DMA.
  * The ADC readings are stored in the ADC_Results[] array inside the dma.c driver.
+ * Define FLEXSCAN_CONTINUOUS to keep sampling forever into the ADC_Stream[] ping-pong buffer instead,
+ * ADC_Stream_half() is called with each half as soon as the DMA has filled it and decimates each
+ * channel by 16 into ADC_Decimated[] with 2 extra bits (14-bit results): moving average for the
+ * references, 3rd order CIC for the pot. Each result is also logged in ADC_Log with its channel and
+ * its LPIT 64-bit timestamp, the main loop consumes the log in batches.
+ * Define FLEXSCAN_SEQUENCE instead to run the channel list of ADC_Seq_channels[] without end
+ * (the pot oversampled 4 times): the DMA writes each conversion into SC1A and
+ * the results into ADC_Seq_results[], the core only reads them.
+ * Define FLEXSCAN_MONITOR instead to supervise the pot every 100 ms with the ADC compare function:
+ * the ADC0 interrupt only happens when the pot leaves or re-enters the 1000 - 3000 window.
  * */
 
 #include "device_registers.h" 	/* include peripheral declarations S32K116 */
@@ -44,6 +54,61 @@
 #include "clocks_and_modes_S32K11x.h"
 #include "pdb.h"
 #include "ADC.h"
+#include "filter.h"
+#include "logger.h"
+#include "LPIT.h"
+
+#ifdef FLEXSCAN_CONTINUOUS
+#define STREAM_SIZE 24								/* Samples of the ping-pong buffer (two halves of 12) */
+uint32_t volatile ADC_Stream[STREAM_SIZE];			/* Destination of the continuous ADC results */
+uint32_t volatile ADC_Stream_last[STREAM_SIZE / 2];	/* Copy of the last half processed */
+#define STREAM_CHANNELS 3							/* VREFL, VREFH, Pot interleaved in the buffer (ADC_SC1A_CH) */
+FILTER_Decimator_t ADC_Decimator[STREAM_CHANNELS];
+uint16_t volatile ADC_Decimated[STREAM_CHANNELS];	/* Last decimated result of each channel (14 bits) */
+const uint8_t ADC_Stream_channels[STREAM_CHANNELS] = {30, 29, 3};	/* ADCH of each result, same order as ADC_SC1A_CH */
+#define STREAM_PERIOD ((uint32_t)(31250ull * 128u * 20u * LPIT_TIMESTAMP_HZ / 48000000u))	/* PDB_FlexScan_Config period in LPIT clocks */
+LOG_Ring_t ADC_Log;									/* Timestamped results, filled from the DMA interrupt */
+LOG_Record_t ADC_Log_last;							/* Last record consumed */
+
+void ADC_Stream_half(uint32_t volatile * samples, uint16_t count)
+{
+	uint64_t timestamp = LPIT0_timestamp();			/* The last result of the half has just been moved */
+	uint16_t out[STREAM_SIZE / 2 / STREAM_CHANNELS + 1];
+	uint16_t i, n;
+
+	LOG_Ring_push_block(&ADC_Log, samples, count, ADC_Stream_channels, STREAM_CHANNELS, timestamp, STREAM_PERIOD);
+	for (i = 0; i < count; i++) {
+		ADC_Stream_last[i] = samples[i];	/* Process the half while the DMA fills the other one */
+	}
+	for (i = 0; i < STREAM_CHANNELS; i++) {
+		n = FILTER_Decimator_run(&ADC_Decimator[i], &samples[i], count / STREAM_CHANNELS, STREAM_CHANNELS, out);
+		if (n > 0) {
+			ADC_Decimated[i] = out[n - 1];
+		}
+	}
+}
+#endif
+
+#ifdef FLEXSCAN_SEQUENCE
+const uint8_t ADC_Seq_channels[3] = {30, 29, 3};	/* VREFL, VREFH, Pot */
+const uint8_t ADC_Seq_oversampling[3] = {1, 1, 4};	/* Conversions of each channel per sequence */
+uint32_t ADC_Seq_commands[6];						/* SC1A values, sum of ADC_Seq_oversampling */
+uint32_t volatile ADC_Seq_results[6];				/* ADC results, same size */
+DMA_Sequence_t ADC_Seq;
+uint16_t volatile ADC_Pot;							/* Average of the pot results */
+#endif
+
+#ifdef FLEXSCAN_MONITOR
+uint32_t volatile ADC_Monitor_events;				/* Limit crossings so far */
+uint16_t volatile ADC_Monitor_last;					/* Result of the last crossing */
+
+void ADC_Monitor_event(uint16_t adc_raw_result, uint8_t alarm)
+{
+	ADC_Monitor_events++;
+	ADC_Monitor_last = adc_raw_result;
+	(void) alarm;							/* 1: pot out of the window, 0: back in it */
+}
+#endif
 
 void WDOG_disable (void)
 {
@@ -57,24 +122,63 @@ int main(void)
 	WDOG_disable();        			/* Disable WDOG */
 	SOSC_init_40MHz();      			/* Initialize system oscillator for 8 MHz xtal */
 	RUN_mode_48MHz(); /* Initialize operation frecuency 48MHz*/
+#if defined(FLEXSCAN_MONITOR)
+	ADC_Monitor_Config(3, ADC_MONITOR_OUTSIDE, 1000, 3000, ADC_Monitor_event);	/* Pot out of 1000 - 3000 */
+	ADC_Timing_config(8000000u, 10, 12, 10000);	/* SOSCDIV2 (8 MHz xtal), 10 results/s of the 10 kOhm pot: 32 samples averaged */
+	PDB_Scan_Config(1, 1875, 0);	/* One conversion of SC1[0] every 100 ms */
+#elif defined(FLEXSCAN_SEQUENCE)
+	ADC_Sequence_Config();			/* Initialize ADC0 with SW Trigger and DMA Request */
+	DMA_Sequence_Config(&ADC_Seq, ADC_Seq_channels, ADC_Seq_oversampling, 3, ADC_Seq_commands, ADC_Seq_results);
+	DMA_Sequence_start(&ADC_Seq);	/* Conversions run back to back from now on */
+#else
 	ADC_FlexScan_Config();			/* Initialize ADC0 CH0 with HW Trigger and DMA Request */
 	DMAMUX_FlexScan_init();			/* Initialize DMA to take requests from ADC0	*/
+#ifdef FLEXSCAN_CONTINUOUS
+	LPIT0_timestamp_init();
+	LOG_Ring_init(&ADC_Log);
+	FILTER_Decimator_init(&ADC_Decimator[0], FILTER_MOVING_AVERAGE, 1, 4, 2);	/* VREFL: 16 results per output, 14 bits */
+	FILTER_Decimator_init(&ADC_Decimator[1], FILTER_MOVING_AVERAGE, 1, 4, 2);	/* VREFH */
+	FILTER_Decimator_init(&ADC_Decimator[2], FILTER_CIC, 3, 4, 2);				/* Pot: 3rd order CIC, 16 results per output */
+	DMA_TCD_FlexScan_Stream_Config(ADC_Stream, STREAM_SIZE, ADC_Stream_half);	/* Same as below but filling ADC_Stream[] without end */
+#else
 	DMA_TCD_FlexScan_Config();		/* Set up TCD CH0 to save measurements from ADC0 and link to CH1 to change ADC0 channel to measure */
+#endif
 	DMA->SERQ = DMA_SERQ_SERQ(0);	/* Enable Requests for DMA Channel 0 */
 
 	PDB_FlexScan_Config();			/* Configure PDB to trigger ADC0 every second */
 
 	S32_NVIC->ISER[0] |= 1<<(0%32);	/*	Enable interruption for DMA CH0	*/
+#endif
 
         for(;;) {       
-
+#ifdef FLEXSCAN_CONTINUOUS
+        	const LOG_Record_t * records;
+        	uint16_t n = LOG_Ring_read(&ADC_Log, &records);	/* Batch of records, export them to CAN, UART... */
+        	if (n > 0) {
+        		ADC_Log_last = records[n - 1];
+        		LOG_Ring_release(&ADC_Log, n);				/* One index update for the whole batch */
+        	}
+#endif
+#ifdef FLEXSCAN_SEQUENCE
+        	ADC_Pot = DMA_Sequence_average(&ADC_Seq, 2);	/* Latest pot value, no ADC handling by the core */
+#endif
         }
 
 	return 0;
 }
 
+#ifdef FLEXSCAN_MONITOR
+void ADC0_IRQHandler (void) {
+	ADC_Monitor_IRQ();				/* Only called when a limit is crossed */
+}
+#endif
+
 void DMA0_IRQHandler (void) {
+#ifdef FLEXSCAN_CONTINUOUS
+	DMA_FlexScan_Stream_IRQ();		/* Clear flags and hand the filled half to ADC_Stream_half */
+#else
 	DMA->CDNE = DMA_CDNE_CDNE(0);	/* Clear Done Status Flag of DMA Channel 0 */
 	DMA->CINT = DMA_CINT_CINT(0);	/* Clear Interruption request flag of DMA Channel 0 */
 	PDB0->SC &=~ PDB_SC_PDBEN_MASK;	/* Turn off PDB to stop getting samples after DMA CH0 major loop */
+#endif
 }
@@ -123,3 +123,70 @@ void PDB_FlexScan_Config(void){
 	PDB0->SC |= PDB_SC_SWTRIG_MASK; /* Software Initial PDB trigger */
 }
 
+/*!	PDB0 configuration for a scan of count ADC0 slots (ADC_Scan_Config)
+ * 		PDB0 counts = Sys. Clock / (Prescaler * Mult factor) = 48 MHz / (128 * 20) = 18750 per second
+ * 	Pre-trigger n of channel 0 triggers ADC0 SC1[n], pre-trigger n of channel 1
+ * 	triggers SC1[8 + n]. Pre-trigger 0 of channel 0 is triggered at the delay,
+ * 	every other pre-trigger of the scan is in Back-to-Back mode: it waits for
+ * 	the conversion of the previous one. The back-to-back chain of the S32K1
+ * 	goes on from pre-trigger 7 of channel 0 to pre-trigger 0 of channel 1, so
+ * 	the whole scan runs at the maximum conversion rate whatever the
+ * 	conversion time (ADC_Timing_config, averaging). The period must be longer
+ * 	than the scan, otherwise the next start finds it running (sequence error).
+ *
+ * 		@param [uint8_t count] Number of slots, 1 to PDB_CH_COUNT * PDB_DLY_COUNT. 0 is
+ * 			ignored, larger values are cut to PDB_CH_COUNT * PDB_DLY_COUNT.
+ * 		@param [uint16_t period] PDB0 period in counts.
+ * 		@param [uint16_t delay] Counts from the start of the period to the first conversion.
+ */
+void PDB_Scan_Config(uint8_t count, uint16_t period, uint16_t delay){
+	uint8_t ch;
+	uint8_t pretriggers;
+	uint32_t mask;
+
+	DEV_ASSERT((count > 0u) && (count <= (PDB_CH_COUNT * PDB_DLY_COUNT)));
+	if (count == 0u)
+	{
+		return;							/* Nothing to scan: the PDB is left as it is */
+	}
+	if (count > (PDB_CH_COUNT * PDB_DLY_COUNT))
+	{
+		count = PDB_CH_COUNT * PDB_DLY_COUNT;	/* DEV_ASSERT is empty in release builds */
+	}
+
+	PCC->PCCn[PCC_PDB0_INDEX] &=~ PCC_PCCn_CGC_MASK;	/* Enable clock for PDB */
+	PCC->PCCn[PCC_PDB0_INDEX] |= PCC_PCCn_PCS(0b001);	/* Enable clock for PDB */
+	PCC->PCCn[PCC_PDB0_INDEX] |= PCC_PCCn_CGC_MASK;		/* Enable clock for PDB */
+
+
+	PDB0->SC = PDB_SC_PRESCALER(0b111)| /* Prescaler = 128 */
+			   PDB_SC_TRGSEL(15)|		/* Software trigger selected */
+			   PDB_SC_MULT(0b10)|		/* Mult factor = 20 */
+			   PDB_SC_CONT_MASK;		/* Continuous mode Enable */
+	PDB0->MOD = period;					/* Counts */
+
+	for(ch = 0; ch < PDB_CH_COUNT; ch++)
+	{
+		pretriggers = (count > PDB_DLY_COUNT) ? PDB_DLY_COUNT : count;
+		count -= pretriggers;
+		mask = (1u << pretriggers) - 1u;
+
+		if (ch == 0u)
+		{
+			PDB0->CH[ch].C1 = (PDB_C1_BB(mask & ~1u)| 	/* Back-to-back for pre-triggers 1..n-1 */
+							   PDB_C1_TOS(mask & 1u)| 	/* Trigger pre-trigger 0 when delay is complete */
+							   PDB_C1_EN(mask));		/* Pre-triggers of the scan enabled */
+			PDB0->CH[ch].DLY[0] = delay;
+		}
+		else
+		{
+			PDB0->CH[ch].C1 = (PDB_C1_BB(mask)| 		/* Back-to-back from the last conversion of the previous channel */
+							   PDB_C1_EN(mask));		/* Pre-triggers of the scan enabled */
+		}
+	}
+
+	PDB0->SC |= PDB_SC_PDBEN_MASK|	/* Enable PDB */
+				PDB_SC_LDOK_MASK;	/* Load MOD and DLY */
+
+	PDB0->SC |= PDB_SC_SWTRIG_MASK; /* Software Initial PDB trigger */
+}
@@ -38,5 +38,6 @@
 void PDB0_init(void);
 void PDB_Config(void);
 void PDB_FlexScan_Config(void);
+void PDB_Scan_Config(uint8_t count, uint16_t period, uint16_t delay);
 
 #endif /* DRIVERS_PDB_PDB_H_ */
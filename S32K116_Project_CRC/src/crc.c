@@ -30,11 +30,30 @@
  * THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #include "crc.h"
 #include "device_registers.h"
 
 #define POLY (0x04C11DB7)
 
+static CRC_Context_t *CRC_owner = 0;	/* Stream whose intermediate value is in CRC->DATA */
+static const uint8_t *CRC_DMA_tail;			/* Bytes left after the words moved by the DMA */
+static uint32_t CRC_DMA_tail_size;
+static uint8_t volatile CRC_DMA_pending = 0;	/* A CRC_update_DMA transfer is in progress */
+static uint8_t CRC_SW_table[256];			/* Table of the software engine, one byte at a time */
+static uint16_t CRC_SW_key = 0xFFFFu;		/* Polynomial and reflection the table was built for */
+
+const CRC_Profile_t CRC_Profiles[CRC_PROFILE_COUNT] =
+{
+	/* width refin refout poly        seed        xorout      check */
+	{  8,    0,    0,     0x1Du,      0xFFu,      0xFFu,      0x4Bu       },	/* CRC_PROFILE_CRC8_SAE_J1850 */
+	{  8,    0,    0,     0x2Fu,      0xFFu,      0xFFu,      0xDFu       },	/* CRC_PROFILE_CRC8_H2F */
+	{  16,   0,    0,     0x1021u,    0xFFFFu,    0x0000u,    0x29B1u     },	/* CRC_PROFILE_CRC16_CCITT */
+	{  16,   1,    1,     0x8005u,    0xFFFFu,    0x0000u,    0x4B37u     },	/* CRC_PROFILE_CRC16_MODBUS */
+	{  32,   1,    1,     0x04C11DB7u,0xFFFFFFFFu,0xFFFFFFFFu,0xCBF43926u },	/* CRC_PROFILE_CRC32 */
+	{  32,   1,    1,     0x1EDC6F41u,0xFFFFFFFFu,0xFFFFFFFFu,0xE3069283u },	/* CRC_PROFILE_CRC32C */
+};
+
 uint32_t CRC_32bits_calculate(uint8_t *data, uint32_t size)
 {
 	/*! CRC-32 Algorithm: \n
@@ -43,24 +62,381 @@ uint32_t CRC_32bits_calculate(uint8_t *data, uint32_t size)
 	 * Bits in a byte are transposed for writes. \n
 	 * Both bits in bytes and bytes are transposed for read. \n
 	 * XOR on reading. \n
+	 * Every element of data is one byte of the message, so the result is the
+	 * standard CRC-32 (check "123456789" = 0xCBF43926, "A" = 0xD3D99E8B).
+	 * Earlier versions wrote each byte to DATA as a 32-bit word, which added
+	 * three leading zero bytes: "A" gave 547335706 (0x209FAE1A), the CRC-32 of
+	 * 00 00 00 41. \n
 	*/
+	CRC_Context_t ctx;
+
+	CRC_begin(&ctx, POLY, 0xFFFFFFFF, CRC_CTRL_CRC32);
+	CRC_update(&ctx, data, size);	/* write data values */
+
+	return CRC_final(&ctx);
+}
+
+/*!
+* @brief CTRL settings for 32-bit data writes. The module takes the most
+* significant byte of a write first, so the byte transposition of TOT is
+* toggled to feed the little-endian words in memory order.
+*/
+static uint32_t CRC_word_ctrl(uint32_t ctrl)
+{
+	uint32_t tot = (ctrl & CRC_CTRL_TOT_MASK) >> CRC_CTRL_TOT_SHIFT;
+
+	return (ctrl & ~CRC_CTRL_TOT_MASK) | CRC_CTRL_TOT(3u - tot);
+}
+
+/*!
+* @brief Save the intermediate value of the stream loaded in the CRC module
+* into its context. Reading with TOTR = 0 and FXOR = 0 gives the raw value.
+*/
+void CRC_save(void)
+{
+	while (CRC_DMA_busy()) {}	/* The value is not final while the DMA feeds the module */
+	if (CRC_owner != 0)
+	{
+		CRC->CTRL = CRC_owner->ctrl & ~(CRC_CTRL_TOTR_MASK | CRC_CTRL_FXOR_MASK);	/* Raw read */
+		CRC_owner->state = CRC->DATAu.DATA;
+		CRC->CTRL = CRC_owner->ctrl;
+		CRC_owner = 0;
+	}
+}
+
+/*!
+* @brief Load a stream into the CRC module, saving the one that was loaded.
+* Nothing is done if the stream is already loaded.
+*
+* @param[CRC_Context_t *ctx] Stream to load.
+*/
+static void CRC_load(CRC_Context_t *ctx)
+{
+	if (CRC_owner != ctx)
+	{
+		CRC_save();
+
+		CRC->GPOLY = ctx->poly;
+		CRC->CTRL = (ctx->ctrl & ~CRC_CTRL_TOT_MASK) | CRC_CTRL_WAS_MASK;	/* Set CRC_CTRL[WAS] to program the value, not transposed */
+		CRC->DATAu.DATA = ctx->state;
+		CRC->CTRL = ctx->ctrl;		/* Clear CRC_CTRL[WAS] to start writing data values. */
 
+		CRC_owner = ctx;
+	}
+}
+
+/*!
+* @brief Start a CRC stream. The CRC module is not touched until the first
+* CRC_update, so several streams can be in progress at the same time.
+*
+* @param[CRC_Context_t *ctx] Stream context.
+* @param[uint32_t poly] Polynomial (GPOLY).
+* @param[uint32_t seed] Seed value, written as is (not transposed).
+* @param[uint32_t ctrl] CTRL settings (TCRC, TOT, TOTR, FXOR), e.g. CRC_CTRL_CRC32.
+*/
+void CRC_begin(CRC_Context_t *ctx, uint32_t poly, uint32_t seed, uint32_t ctrl)
+{
 	PCC->PCCn[PCC_CRC_INDEX] |= PCC_PCCn_CGC_MASK;	/* enable CRC clock */
 
-	CRC->CTRL |= CRC_CTRL_TCRC(1);	/* enable 32-bit CRC protocol */
-	CRC->CTRL |= CRC_CTRL_TOT(1);	/* Bits in a byte are transposed, while bytes are not transposed. */
-	CRC->CTRL |= CRC_CTRL_TOTR(2);	/* Both bits in bytes and bytes are transposed. */
-	CRC->CTRL |= CRC_CTRL_FXOR(1);	/* XOR on reading. */
+	if (CRC_owner == ctx)
+	{
+		CRC_owner = 0;	/* Restart of the loaded stream: reload it with the new seed */
+	}
+	ctx->ctrl = ctrl & (CRC_CTRL_TCRC_MASK | CRC_CTRL_TOT_MASK | CRC_CTRL_TOTR_MASK | CRC_CTRL_FXOR_MASK);
+	ctx->poly = poly;
+	ctx->state = seed;
+	ctx->profile = 0;
+}
+
+/*!
+* @brief Reverse the order of the lowest bits of a value.
+*/
+static uint32_t CRC_reflect(uint32_t value, uint8_t bits)
+{
+	uint32_t result = 0;
+
+	for(;bits--;value >>= 1)
+	result = (result << 1) | (value & 1u);
+
+	return result;
+}
 
-		CRC->GPOLY = POLY;	
+/*!
+* @brief Returns 1 if the profile of a stream is computed by software.
+* The CRC module only knows 16 and 32-bit CRCs.
+*/
+static uint8_t CRC_SW_profile(const CRC_Context_t *ctx)
+{
+	return (ctx->profile != 0) && (ctx->profile->width == 8u);
+}
+
+/*!
+* @brief Build the byte table of the software engine for an 8-bit profile.
+* The table is kept while the same polynomial and reflection are used.
+*/
+static void CRC_SW_table_init(const CRC_Profile_t *profile)
+{
+	uint16_t key = (uint16_t) ((profile->poly & 0xFFu) | ((uint32_t) profile->refin << 8));
+	uint8_t poly = (uint8_t) (profile->refin ? CRC_reflect(profile->poly, 8) : profile->poly);
+	uint32_t i;
+	uint8_t bit;
+	uint8_t crc;
 
-	CRC->CTRL |= CRC_CTRL_WAS_MASK;	/* Set CRC_CTRL[WAS] to program the seed value. */
-	CRC->DATAu.DATA = 0xFFFFFFFF;	/* seed value */
+	if (CRC_SW_key == key)
+	{
+		return;
+	}
+
+	for(i = 0;i < 256u;i++)
+	{
+		crc = (uint8_t) i;
+		for(bit = 0;bit < 8u;bit++)
+		{
+			if (profile->refin)
+			{
+				crc = (crc & 1u) ? (uint8_t) ((crc >> 1) ^ poly) : (uint8_t) (crc >> 1);
+			}
+			else
+			{
+				crc = (crc & 0x80u) ? (uint8_t) ((crc << 1) ^ poly) : (uint8_t) (crc << 1);
+			}
+		}
+		CRC_SW_table[i] = crc;
+	}
+	CRC_SW_key = key;
+}
+
+/*!
+* @brief Start a CRC stream of a preset profile. 16 and 32-bit profiles are
+* computed by the CRC module, 8-bit ones by a table-driven software engine.
+* The final XOR is applied by CRC_final, so any xorout value is supported.
+*
+* @param[CRC_Context_t *ctx] Stream context.
+* @param[CRC_Profile_id_t id] Profile, e.g. CRC_PROFILE_CRC32C.
+*/
+void CRC_begin_profile(CRC_Context_t *ctx, CRC_Profile_id_t id)
+{
+	const CRC_Profile_t *profile = &CRC_Profiles[id];
+
+	CRC_begin(ctx, profile->poly, profile->seed,
+			  CRC_CTRL_TCRC(profile->width == 32u) |	/* 32 or 16-bit CRC protocol */
+			  CRC_CTRL_TOT(profile->refin) |			/* Bits in a byte are transposed for writes */
+			  CRC_CTRL_TOTR(profile->refout << 1));		/* Both bits in bytes and bytes are transposed for read */
+	ctx->profile = profile;
+
+	if (CRC_SW_profile(ctx))
+	{
+		CRC_SW_table_init(profile);
+		ctx->state = profile->refin ? CRC_reflect(profile->seed, 8) : (profile->seed & 0xFFu);
+	}
+}
+
+/*!
+* @brief CRC of a buffer with a preset profile.
+*
+* @param[CRC_Profile_id_t id] Profile.
+* @param[const uint8_t *data] Data.
+* @param[uint32_t size] Amount of bytes.
+*
+* @return CRC of the data.
+*/
+uint32_t CRC_calculate(CRC_Profile_id_t id, const uint8_t *data, uint32_t size)
+{
+	CRC_Context_t ctx;
 
-	CRC->CTRL &= ~CRC_CTRL_WAS_MASK;	/* Clear CRC_CTRL[WAS] to start writing data values. */
-	for(;size--;)
-	CRC->DATAu.DATA = *data++;	/* write data values */
+	CRC_begin_profile(&ctx, id);
+	CRC_update(&ctx, data, size);
 
-return (uint32_t) CRC->DATAu.DATA;
+	return CRC_final(&ctx);
 }
 
+/*!
+* @brief Self-test of a profile against its check value, the CRC of the
+* ASCII string "123456789".
+*
+* @param[CRC_Profile_id_t id] Profile.
+*
+* @return 1 if the profile gives its check value.
+*/
+uint8_t CRC_profile_check(CRC_Profile_id_t id)
+{
+	static const uint8_t check_string[9] = {'1','2','3','4','5','6','7','8','9'};
+
+	return CRC_calculate(id, check_string, sizeof(check_string)) == CRC_Profiles[id].check;
+}
+
+/*!
+* @brief Add data to a CRC stream.
+*
+* @param[CRC_Context_t *ctx] Stream context.
+* @param[const uint8_t *data] Data.
+* @param[uint32_t size] Amount of bytes.
+*/
+void CRC_update(CRC_Context_t *ctx, const uint8_t *data, uint32_t size)
+{
+	const uint32_t *words;
+	uint32_t count;
+
+	if (CRC_SW_profile(ctx))
+	{
+		CRC_SW_table_init(ctx->profile);	/* Another 8-bit profile may have used the table */
+		for(;size--;)
+		ctx->state = CRC_SW_table[(ctx->state ^ *data++) & 0xFFu];
+		return;
+	}
+
+	while (CRC_DMA_busy()) {}	/* Data must be added in order */
+	CRC_load(ctx);
+
+	for(;size && ((uint32_t) data & 3u);size--)
+	CRC->DATAu.DATA_8.LL = *data++;	/* unaligned head, one byte per write */
+
+	count = size >> 2;
+	if (count > 0u)
+	{
+		CRC->CTRL = CRC_word_ctrl(ctx->ctrl);
+		words = (const uint32_t *) data;
+		for(;count--;)
+		CRC->DATAu.DATA = *words++;	/* body, four bytes per write */
+		CRC->CTRL = ctx->ctrl;
+		data = (const uint8_t *) words;
+	}
+
+	for(size &= 3u;size--;)
+	CRC->DATAu.DATA_8.LL = *data++;	/* tail, one byte per write */
+}
+
+/*!
+* @brief Add data to a CRC stream using the DMA. The aligned words of the
+* buffer are written into CRC->DATA by channel CRC_DMA_CH (always enabled
+* request), the unaligned head is written by the CPU before and the tail by
+* CRC_DMA_IRQ after the major loop, so the function returns right after
+* starting the transfer. The buffer must not change until CRC_DMA_busy
+* returns 0. CRC_DMA_IRQ must be called from DMA0_IRQHandler (CRC_DMA_CH).
+*
+* @param[CRC_Context_t *ctx] Stream context.
+* @param[const uint8_t *data] Data (e.g. a flash region).
+* @param[uint32_t size] Amount of bytes.
+*/
+void CRC_update_DMA(CRC_Context_t *ctx, const uint8_t *data, uint32_t size)
+{
+	uint32_t head = (4u - ((uint32_t) data & 3u)) & 3u;
+	uint32_t nbytes = 4;
+	uint32_t body;
+
+	if (CRC_SW_profile(ctx))
+	{
+		CRC_update(ctx, data, size);	/* No hardware for this profile */
+		return;
+	}
+	if (head > size)
+	{
+		head = size;
+	}
+	CRC_update(ctx, data, head);	/* Head by the CPU, also waits for a previous transfer */
+	data += head;
+	size -= head;
+
+	while (((size & ~3u) / nbytes) > 0x7FFFu)
+	{
+		nbytes <<= 1;	/* Keep CITER inside its 15 bits */
+	}
+	body = size - (size % nbytes);
+	if (body == 0u)
+	{
+		CRC_update(ctx, data, size);
+		return;
+	}
+
+	CRC_DMA_tail = data + body;
+	CRC_DMA_tail_size = size - body;
+	CRC_DMA_pending = 1;
+
+	SIM->PLATCGC |= SIM_PLATCGC_CGCDMA_MASK;			/* DMA Clock Gating Control Enable */
+	PCC->PCCn[PCC_DMAMUX_INDEX] |= PCC_PCCn_CGC_MASK;	/* Enable clock for DMAMUX */
+	DMAMUX->CHCFG[CRC_DMA_CH] = DMAMUX_CHCFG_SOURCE(EDMA_REQ_DMAMUX_ALWAYS_ENABLED0) | DMAMUX_CHCFG_ENBL_MASK;
+
+	CRC->CTRL = CRC_word_ctrl(ctx->ctrl);		/* Word writes until the tail */
+
+	DMA->TCD[CRC_DMA_CH].SADDR        = DMA_TCD_SADDR_SADDR((uint32_t) data);		/* Source Address */
+	DMA->TCD[CRC_DMA_CH].SOFF         = DMA_TCD_SOFF_SOFF(4);						/* Src. addr add 4 bytes after transfers */
+	DMA->TCD[CRC_DMA_CH].ATTR         = DMA_TCD_ATTR_SSIZE(2) |						/* Src. read 32 bits per transfer */
+										DMA_TCD_ATTR_DSIZE(2);						/* Dest. write 32 bits per transfer */
+	DMA->TCD[CRC_DMA_CH].NBYTES.MLNO  = DMA_TCD_NBYTES_MLNO_NBYTES(nbytes);			/* Words per minor loop */
+	DMA->TCD[CRC_DMA_CH].SLAST        = DMA_TCD_SLAST_SLAST(0);
+	DMA->TCD[CRC_DMA_CH].DADDR        = DMA_TCD_DADDR_DADDR((uint32_t) &CRC->DATAu.DATA);	/* CRC data register */
+	DMA->TCD[CRC_DMA_CH].DOFF         = DMA_TCD_DOFF_DOFF(0);						/* Always the same register */
+	DMA->TCD[CRC_DMA_CH].CITER.ELINKNO= DMA_TCD_CITER_ELINKNO_CITER(body / nbytes);
+	DMA->TCD[CRC_DMA_CH].DLASTSGA     = DMA_TCD_DLASTSGA_DLASTSGA(0);
+	DMA->TCD[CRC_DMA_CH].CSR          = DMA_TCD_CSR_INTMAJOR(1) |					/* IRQ after major loop */
+										DMA_TCD_CSR_DREQ(1);						/* Disable chan after major loop */
+	DMA->TCD[CRC_DMA_CH].BITER.ELINKNO= DMA_TCD_BITER_ELINKNO_BITER(body / nbytes);
+
+	DMA->SERQ = DMA_SERQ_SERQ(CRC_DMA_CH);	/* Start feeding the CRC module */
+}
+
+/*!
+* @brief Returns 1 while a CRC_update_DMA transfer is in progress.
+*/
+uint8_t CRC_DMA_busy(void)
+{
+	return CRC_DMA_pending;
+}
+
+/*!
+* @brief End of a CRC_update_DMA transfer, to be called from the interrupt of
+* CRC_DMA_CH: the tail bytes are added and the stream can be used again.
+*/
+void CRC_DMA_IRQ(void)
+{
+	DMA->CDNE = DMA_CDNE_CDNE(CRC_DMA_CH);	/* Clear Done Status Flag */
+	DMA->CINT = DMA_CINT_CINT(CRC_DMA_CH);	/* Clear Interruption request flag */
+
+	CRC->CTRL = CRC_owner->ctrl;			/* Back to byte writes */
+	for(;CRC_DMA_tail_size--;)
+	CRC->DATAu.DATA_8.LL = *CRC_DMA_tail++;	/* tail, one byte per write */
+
+	CRC_DMA_pending = 0;
+}
+
+/*!
+* @brief End a CRC stream and return its CRC (transposed and XORed as set in
+* CTRL, or as set in the profile). The stream releases the CRC module.
+*
+* @param[CRC_Context_t *ctx] Stream context.
+*
+* @return CRC of all the data of the stream.
+*/
+uint32_t CRC_final(CRC_Context_t *ctx)
+{
+	uint32_t result;
+
+	if (CRC_SW_profile(ctx))
+	{
+		result = ctx->state;
+		if (ctx->profile->refin != ctx->profile->refout)
+		{
+			result = CRC_reflect(result, 8);
+		}
+		return (result ^ ctx->profile->xorout) & 0xFFu;
+	}
+
+	while (CRC_DMA_busy()) {}	/* Wait for the data fed by the DMA */
+	CRC_load(ctx);
+	result = CRC->DATAu.DATA;
+
+	if ((ctx->ctrl & CRC_CTRL_TCRC_MASK) == 0u)
+	{
+		/* 16-bit CRC: in DATAH when bytes are transposed for read, in DATAL otherwise */
+		result = (ctx->ctrl & CRC_CTRL_TOTR(2)) ? (result >> 16) : (result & 0xFFFFu);
+	}
+
+	CRC_save();		/* Keep the value in the context and release the module */
+
+	if (ctx->profile != 0)
+	{
+		result ^= ctx->profile->xorout;	/* No FXOR for profiles, xorout is not always all ones */
+	}
+
+	return result;
+}
@@ -30,10 +30,65 @@
  * THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #ifndef CRC_H_
 #define CRC_H_
 
 #include "device_registers.h"
+
+/* CTRL settings of the CRC-32 computed by CRC_32bits_calculate */
+#define CRC_CTRL_CRC32	(CRC_CTRL_TCRC(1) |	/* 32-bit CRC protocol */	\
+						 CRC_CTRL_TOT(1)  |	/* Bits in a byte are transposed for writes */	\
+						 CRC_CTRL_TOTR(2) |	/* Both bits in bytes and bytes are transposed for read */	\
+						 CRC_CTRL_FXOR(1))	/* XOR on reading */
+
+#define CRC_DMA_CH	0	/* DMA channel that feeds CRC_update_DMA transfers into the CRC module */
+
+/* Preset CRC algorithms, index of CRC_Profiles[] */
+typedef enum
+{
+	CRC_PROFILE_CRC8_SAE_J1850 = 0,	/* AUTOSAR E2E profiles 1 and 2 */
+	CRC_PROFILE_CRC8_H2F,			/* AUTOSAR CRC8H2F */
+	CRC_PROFILE_CRC16_CCITT,		/* CRC-16/CCITT-FALSE */
+	CRC_PROFILE_CRC16_MODBUS,		/* Modbus RTU */
+	CRC_PROFILE_CRC32,				/* Ethernet, zlib, bootloader images */
+	CRC_PROFILE_CRC32C,				/* Castagnoli, iSCSI */
+	CRC_PROFILE_COUNT
+}CRC_Profile_id_t;
+
+/* CRC algorithm, in the usual width/poly/init/refin/refout/xorout notation */
+typedef struct
+{
+	uint8_t width;		/* 8, 16 or 32 bits. Only 16 and 32 are computed by the CRC module */
+	uint8_t refin;		/* 1: bits of the data bytes are reflected */
+	uint8_t refout;		/* 1: bits of the result are reflected */
+	uint32_t poly;		/* Polynomial, not reflected */
+	uint32_t seed;		/* Initial value, not reflected */
+	uint32_t xorout;	/* Value XORed with the result */
+	uint32_t check;		/* CRC of the ASCII string "123456789" */
+}CRC_Profile_t;
+
+extern const CRC_Profile_t CRC_Profiles[CRC_PROFILE_COUNT];
+
+/* State of one CRC stream, several streams can share the CRC module. */
+typedef struct
+{
+	uint32_t ctrl;		/* CTRL settings (TCRC, TOT, TOTR, FXOR) */
+	uint32_t poly;		/* GPOLY value */
+	uint32_t state;		/* Intermediate CRC value, as stored in DATA (not transposed nor XORed) */
+	const CRC_Profile_t *profile;	/* Profile of CRC_begin_profile, 0 for CRC_begin */
+}CRC_Context_t;
+
 uint32_t CRC_32bits_calculate(uint8_t *data, uint32_t size);
+void CRC_begin(CRC_Context_t *ctx, uint32_t poly, uint32_t seed, uint32_t ctrl);
+void CRC_update(CRC_Context_t *ctx, const uint8_t *data, uint32_t size);
+uint32_t CRC_final(CRC_Context_t *ctx);
+void CRC_begin_profile(CRC_Context_t *ctx, CRC_Profile_id_t id);
+uint32_t CRC_calculate(CRC_Profile_id_t id, const uint8_t *data, uint32_t size);
+uint8_t CRC_profile_check(CRC_Profile_id_t id);
+void CRC_save(void);
+void CRC_update_DMA(CRC_Context_t *ctx, const uint8_t *data, uint32_t size);
+uint8_t CRC_DMA_busy(void);
+void CRC_DMA_IRQ(void);
 
 #endif /* CRC_H_ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "flash_scan.h"
+#include "crc.h"
+#include "device_registers.h"
+
+extern uint8_t __image_start__[];
+extern uint8_t __image_end__[];
+
+/* Reference CRC-32 of the image, erased until the post-build step writes it.
+ * Volatile so that the compiler reads flash instead of using the initializer. */
+const uint32_t volatile FLASH_Image_crc __attribute__((section(".image_crc"))) = 0xFFFFFFFFu;
+
+FLASH_Scan_t volatile FLASH_Scan;
+
+static CRC_Context_t FLASH_Scan_ctx;		/* CRC stream of the pass in progress */
+static const uint8_t *FLASH_Scan_next;		/* Next byte of the image to add */
+
+/*!
+* @brief Start a new pass over the flash image.
+*/
+static void FLASH_Scan_restart(void)
+{
+	CRC_begin_profile(&FLASH_Scan_ctx, CRC_PROFILE_CRC32);
+	FLASH_Scan_next = __image_start__;
+}
+
+/*!
+* @brief Initialize the flash image scanner. Nothing is read from flash here,
+* the image is checked by the following FLASH_Scan_step calls.
+*/
+void FLASH_Scan_init(void)
+{
+	FLASH_Scan.status = FLASH_SCAN_PENDING;
+	FLASH_Scan.passes = 0;
+	FLASH_Scan.errors = 0;
+	FLASH_Scan.crc = 0;
+	FLASH_Scan_restart();
+}
+
+/*!
+* @brief Background step of the flash image scanner, to be called from the
+* idle loop. Each call adds at most FLASH_SCAN_CHUNK bytes to the CRC, so the
+* time taken per call is bounded. At the end of the image, the CRC is compared
+* with FLASH_Image_crc, FLASH_Scan is updated and a new pass is started.
+* With FLASH_SCAN_DMA, the chunk is moved by the DMA and the call returns at
+* once while the previous chunk is in progress (CRC_DMA_IRQ must be called from
+* DMA0_IRQHandler).
+*/
+void FLASH_Scan_step(void)
+{
+	uint32_t size = (uint32_t) (__image_end__ - FLASH_Scan_next);
+
+#ifdef FLASH_SCAN_DMA
+	if (CRC_DMA_busy())
+	{
+		return;
+	}
+#endif
+
+	if (size == 0u)
+	{
+		FLASH_Scan.crc = CRC_final(&FLASH_Scan_ctx);
+		if (FLASH_Image_crc == 0xFFFFFFFFu)
+		{
+			FLASH_Scan.status = FLASH_SCAN_NO_REFERENCE;
+		}
+		else if (FLASH_Scan.crc != FLASH_Image_crc)
+		{
+			FLASH_Scan.status = FLASH_SCAN_MISMATCH;
+			FLASH_Scan.errors++;
+		}
+		else if (FLASH_Scan.status != FLASH_SCAN_MISMATCH)
+		{
+			FLASH_Scan.status = FLASH_SCAN_OK;
+		}
+		FLASH_Scan.passes++;
+		FLASH_Scan_restart();
+		return;
+	}
+
+	if (size > FLASH_SCAN_CHUNK)
+	{
+		size = FLASH_SCAN_CHUNK;
+	}
+#ifdef FLASH_SCAN_DMA
+	CRC_update_DMA(&FLASH_Scan_ctx, FLASH_Scan_next, size);
+#else
+	CRC_update(&FLASH_Scan_ctx, FLASH_Scan_next, size);
+#endif
+	FLASH_Scan_next += size;
+}
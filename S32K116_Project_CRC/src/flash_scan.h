@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef FLASH_SCAN_H_
+#define FLASH_SCAN_H_
+
+#include "device_registers.h"
+
+/*
+ * The image [__image_start__, __image_end__) is checked against the CRC-32
+ * stored in the .image_crc section (last word of m_text) by the linker file.
+ * The reference is written after the link, e.g. with SRecord, where END is
+ * the value of __image_end__ in the map file. The gaps of the image are
+ * filled with 0xFF (erased flash) before the CRC, as the scanner reads them:
+ *   srec_cat app.srec -exclude 0x1FFFC 0x20000
+ *            app.srec -crop 0x410 END -fill 0xFF 0x410 END -crc32-l-e 0x1FFFC
+ *            -crop 0x1FFFC 0x20000
+ *            -o app_crc.srec
+ */
+
+//#define FLASH_SCAN_DMA				/* Chunks are fed to the CRC module by the DMA (CRC_update_DMA) */
+#define FLASH_SCAN_CHUNK	256		/* Bytes added to the CRC per FLASH_Scan_step */
+
+typedef enum
+{
+	FLASH_SCAN_PENDING = 0,		/* First pass not finished yet */
+	FLASH_SCAN_OK,				/* Last pass matched the reference */
+	FLASH_SCAN_NO_REFERENCE,	/* Reference still erased, image not checked */
+	FLASH_SCAN_MISMATCH			/* A pass did not match the reference (kept until FLASH_Scan_init) */
+}FLASH_Scan_status_t;
+
+typedef struct
+{
+	FLASH_Scan_status_t status;
+	uint32_t passes;		/* Completed passes over the image */
+	uint32_t errors;		/* Passes that did not match the reference */
+	uint32_t crc;			/* CRC-32 of the last completed pass */
+}FLASH_Scan_t;
+
+extern FLASH_Scan_t volatile FLASH_Scan;
+
+void FLASH_Scan_init(void);
+void FLASH_Scan_step(void);
+
+#endif /* FLASH_SCAN_H_ */
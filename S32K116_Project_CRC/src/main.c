@@ -35,9 +35,11 @@
  * ==========================================================================================
  * The cyclic redundancy check (CRC) module generates 16/32-bit CRC code for error detection.
  * This is a program to show a basic configuration of CRC module following RM steps.
+ * The idle loop then checks the flash image in the background (flash_scan.c).
  */
 
 #include "crc.h"
+#include "flash_scan.h"
 #include "device_registers.h" 	/* include peripheral declarations S32K116 */
 #include "clocks_and_modes_S32K11x.h"
 
@@ -64,7 +66,15 @@ int main(void)
 
 	PCC->PCCn[PCC_CRC_INDEX] |= PCC_PCCn_CGC_MASK;		/* Enable Clock for CRC module */
 	crc = CRC_32bits_calculate(&test, 1);				/* Calculate 32-bit CRC */
-														/* crc = 547335706 */
+														/* crc = 3554254475 (0xD3D99E8B), the standard CRC-32 of "A".	*/
+														/* Versions writing the byte as a 32-bit word gave		*/
+														/* 547335706, the CRC of 00 00 00 41 (see crc.c)		*/
+
+	FLASH_Scan_init();	/* Background check of the flash image */
+#ifdef FLASH_SCAN_DMA
+	S32_NVIC->ICPR[0] |= 1 << (0 % 32);  /* IRQ0-DMA0 ch0: clr any pending IRQ	*/
+	S32_NVIC->ISER[0] |= 1 << (0 % 32);  /* IRQ0-DMA0 ch0: enable IRQ 			*/
+#endif
 
 	/*!
 	 * Wait forever
@@ -72,5 +82,17 @@ int main(void)
 	 */
 	for(;;)
 	{
+		FLASH_Scan_step();	/* One chunk of the image per idle iteration */
+		if (FLASH_Scan.status == FLASH_SCAN_MISMATCH)
+		{
+			/* Flash image corrupted: application specific reaction */
+		}
 	}
 }
+
+#ifdef FLASH_SCAN_DMA
+void DMA0_IRQHandler (void)
+{
+	CRC_DMA_IRQ();	/* End of a chunk moved by CRC_DMA_CH */
+}
+#endif
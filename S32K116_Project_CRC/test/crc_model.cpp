@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string.h>
+#include "crc_model.h"
+
+CRC_Model_t CRC_Model;
+DMA_Type CRC_Model_dma;
+DMAMUX_Type CRC_Model_dmamux;
+SIM_Type CRC_Model_sim;
+PCC_Type CRC_Model_pcc;
+
+static uint32_t CRC_Model_value;		/* CRC register of the module, not transposed */
+static uint32_t CRC_Model_count[2];		/* Data writes of 8 and 32 bits */
+
+/*!
+ * Transposition of the TOT/TOTR encodings: 1 bits in bytes, 2 bits and
+ * bytes, 3 bytes only. Byte writes only see the bit transposition.
+ */
+static uint32_t CRC_Model_transpose(uint32_t value, uint32_t mode, uint8_t bits)
+{
+	uint32_t result = 0;
+	uint8_t byte;
+	uint8_t bit;
+
+	if (mode == 0u) {
+		return value;
+	}
+	for (byte = 0; byte < bits; byte += 8u) {
+		uint32_t in = (value >> byte) & 0xFFu;
+		uint32_t out = in;
+
+		if (mode != 3u) {
+			out = 0;
+			for (bit = 0; bit < 8u; bit++) {
+				out |= ((in >> bit) & 1u) << (7u - bit);
+			}
+		}
+		if ((mode != 1u) && (bits == 32u)) {
+			result |= out << (24u - byte);	/* Bytes transposed */
+		}
+		else {
+			result |= out << byte;
+		}
+	}
+	return result;
+}
+
+void CRC_Model_write(uint32_t value, uint8_t bits)
+{
+	uint32_t ctrl = CRC_Model.CTRL;
+	uint32_t width = (ctrl & CRC_CTRL_TCRC_MASK) ? 32u : 16u;
+	uint32_t top = 1uL << (width - 1u);
+	uint32_t mask = (width == 32u) ? 0xFFFFFFFFu : 0xFFFFu;
+	uint32_t crc;
+	uint8_t bit;
+
+	value = CRC_Model_transpose(value, (ctrl & CRC_CTRL_TOT_MASK) >> CRC_CTRL_TOT_SHIFT, bits);
+	if (ctrl & CRC_CTRL_WAS_MASK) {
+		CRC_Model_value = value;	/* Seed */
+		return;
+	}
+
+	CRC_Model_count[bits == 32u]++;
+	crc = CRC_Model_value & mask;
+	for (bit = bits; bit-- > 0u;) {	/* Most significant bit first */
+		uint32_t feedback = ((crc & top) != 0u) ^ ((value >> bit) & 1u);
+
+		crc = (crc << 1) & mask;
+		if (feedback) {
+			crc ^= CRC_Model.GPOLY & mask;
+		}
+	}
+	CRC_Model_value = (CRC_Model_value & ~mask) | crc;
+}
+
+uint32_t CRC_Model_read(void)
+{
+	uint32_t ctrl = CRC_Model.CTRL;
+	uint32_t value = CRC_Model_transpose(CRC_Model_value, (ctrl & CRC_CTRL_TOTR_MASK) >> CRC_CTRL_TOTR_SHIFT, 32);
+
+	return (ctrl & CRC_CTRL_FXOR_MASK) ? ~value : value;
+}
+
+void CRC_Model_reset(void)
+{
+	CRC_Model.GPOLY = 0x1021u;	/* Reset values of the module */
+	CRC_Model.CTRL = 0;
+	CRC_Model_value = 0xFFFFFFFFu;
+	CRC_Model_count[0] = 0;
+	CRC_Model_count[1] = 0;
+	memset((void *) &CRC_Model_dma, 0, sizeof(CRC_Model_dma));
+}
+
+/*!
+ * Data writes (seeds excluded) of 8 or 32 bits since CRC_Model_reset.
+ */
+uint32_t CRC_Model_writes(uint8_t bits)
+{
+	return CRC_Model_count[bits == 32u];
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CRC_MODEL_H_
+#define CRC_MODEL_H_
+
+/*!
+ * Host model of the CRC module
+ * ===================================================
+ * Runs the crc driver on a PC. CRC->DATA and CRC->DATAu.DATA_8.LL are C++
+ * objects: a write shifts the data through the CRC like the module does
+ * (seed when CTRL[WAS] is set, TOT transposition, 16 or 32-bit CRC with
+ * GPOLY) and a read gives the CRC transposed by TOTR and XORed by FXOR.
+ * DMA, DMAMUX, SIM and PCC are plain host copies of the registers, the test
+ * plays the DMA transfers programmed by CRC_update_DMA.
+ *
+ * Force this file ahead of every source and build crc.c as C++:
+ *   c++ -m32 -DCPU_S32K116 -I. -I../include -I../src -include crc_model.h ... -x c++ ../src/crc.c
+ * The DMA TCDs hold 32-bit addresses, hence the 32-bit host (-m32).
+ */
+
+#include "device_registers.h"
+
+void CRC_Model_write(uint32_t value, uint8_t bits);
+uint32_t CRC_Model_read(void);
+void CRC_Model_reset(void);
+uint32_t CRC_Model_writes(uint8_t bits);
+
+/* CRC_DATA, 32-bit accesses */
+class CRC_Model_data_t
+{
+public:
+	CRC_Model_data_t & operator=(uint32_t value) { CRC_Model_write(value, 32); return *this; }
+	operator uint32_t() const { return CRC_Model_read(); }
+};
+
+/* CRC_DATALL, 8-bit writes */
+class CRC_Model_byte_t
+{
+public:
+	CRC_Model_byte_t & operator=(uint8_t value) { CRC_Model_write(value, 8); return *this; }
+};
+
+typedef struct
+{
+	struct
+	{
+		CRC_Model_data_t DATA;
+		struct
+		{
+			CRC_Model_byte_t LL;
+		}DATA_8;
+	}DATAu;
+	uint32_t volatile GPOLY;
+	uint32_t volatile CTRL;
+}CRC_Model_t;
+
+extern CRC_Model_t CRC_Model;
+extern DMA_Type CRC_Model_dma;
+extern DMAMUX_Type CRC_Model_dmamux;
+extern SIM_Type CRC_Model_sim;
+extern PCC_Type CRC_Model_pcc;
+
+#undef CRC
+#undef DMA
+#undef DMAMUX
+#undef SIM
+#undef PCC
+#define CRC		(&CRC_Model)
+#define DMA		(&CRC_Model_dma)
+#define DMAMUX	(&CRC_Model_dmamux)
+#define SIM		(&CRC_Model_sim)
+#define PCC		(&CRC_Model_pcc)
+
+#endif /* CRC_MODEL_H_ */
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*!
+ * Check of the CRC profiles
+ * ===================================================
+ * Runs crc.c on the CRC module model (crc_model.h) and checks every
+ * profile of CRC_Profiles[]:
+ *  - the catalogue check value of "123456789", written here and not taken
+ *    from the table, and CRC_profile_check;
+ *  - the test vectors of the AUTOSAR CRC specification;
+ *  - every length from 0 to 40 bytes at the 4 alignments, against a bitwise
+ *    implementation of the width/poly/init/refin/refout/xorout definition,
+ *    so the head/word/tail split of CRC_update is covered;
+ *  - two streams updated in turns (CRC_save/CRC_load);
+ *  - CRC_update_DMA, with the transfer programmed in the TCD played here.
+ *
+ * Build and run on a 32-bit host:
+ *   c++ -m32 -DCPU_S32K116 -I. -I../include -I../src -include crc_model.h \
+ *       crc_profiles_test.cpp crc_model.cpp -x c++ ../src/crc.c -o crc_profiles_test && ./crc_profiles_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "crc_model.h"
+#include "crc.h"
+
+#define VECTOR_COUNT	7u
+
+typedef struct
+{
+	uint8_t size;
+	uint8_t data[9];
+}Vector_t;
+
+/* Test vectors of the AUTOSAR CRC specification */
+static const Vector_t Vectors[VECTOR_COUNT] =
+{
+	{ 4, {0x00, 0x00, 0x00, 0x00} },
+	{ 3, {0xF2, 0x01, 0x83} },
+	{ 4, {0x0F, 0xAA, 0x00, 0x55} },
+	{ 4, {0x00, 0xFF, 0x55, 0x11} },
+	{ 9, {0x33, 0x22, 0x55, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF} },
+	{ 3, {0x92, 0x6B, 0x55} },
+	{ 4, {0xFF, 0xFF, 0xFF, 0xFF} },
+};
+
+typedef struct
+{
+	const char *name;
+	uint32_t check;					/* CRC of "123456789" */
+	uint32_t vector[VECTOR_COUNT];	/* CRC of Vectors[] */
+}Expected_t;
+
+static const Expected_t Expected[CRC_PROFILE_COUNT] =
+{
+	{ "CRC8_SAE_J1850", 0x4B,       {0x59, 0x37, 0x79, 0xB8, 0xCB, 0x8C, 0x74} },
+	{ "CRC8_H2F",       0xDF,       {0x12, 0xC2, 0xC6, 0x77, 0x11, 0x33, 0x6C} },
+	{ "CRC16_CCITT",    0x29B1,     {0x84C0, 0xD374, 0x2023, 0xB8F9, 0xF53F, 0x0745, 0x1D0F} },
+	{ "CRC16_MODBUS",   0x4B37,     {0x2400, 0x0290, 0x2FE3, 0x48CF, 0x5E92, 0x223F, 0xB001} },
+	{ "CRC32",          0xCBF43926, {0x2144DF1C, 0x24AB9D77, 0xB6C9B287, 0x32A06212, 0xB0AE863D, 0x9CDEA29B, 0xFFFFFFFF} },
+	{ "CRC32C",         0xE3069283, {0x48674BC7, 0x70ABD088, 0xDEAABEBB, 0xA6ADEA2D, 0xB59CA09B, 0x99357B56, 0xFFFFFFFF} },
+};
+
+static const uint8_t Check_string[] = "123456789";
+static uint8_t Buffer[48] __attribute__ ((aligned(4)));
+static uint32_t failures;
+
+#define CHECK(cond, what)	check((cond) ? 1u : 0u, what, __LINE__)
+
+static void check(uint8_t ok, const char *what, int line)
+{
+	if (!ok) {
+		failures++;
+		printf("  FAIL line %d: %s\n", line, what);
+	}
+}
+
+static uint32_t reflect(uint32_t value, uint8_t bits)
+{
+	uint32_t result = 0;
+
+	for (; bits--; value >>= 1) {
+		result = (result << 1) | (value & 1u);
+	}
+	return result;
+}
+
+/*!
+ * Bitwise CRC straight from the profile definition, one byte at a time.
+ */
+static uint32_t reference(const CRC_Profile_t *profile, const uint8_t *data, uint32_t size)
+{
+	uint32_t top = 1uL << (profile->width - 1u);
+	uint32_t mask = top | (top - 1u);
+	uint32_t crc = profile->seed & mask;
+	uint8_t bit;
+
+	while (size--) {
+		crc ^= (uint32_t) (profile->refin ? reflect(*data, 8) : *data) << (profile->width - 8u);
+		data++;
+		for (bit = 0; bit < 8u; bit++) {
+			crc = (crc & top) ? (((crc << 1) ^ profile->poly) & mask) : ((crc << 1) & mask);
+		}
+	}
+	if (profile->refout) {
+		crc = reflect(crc, profile->width);
+	}
+	return (crc ^ profile->xorout) & mask;
+}
+
+/*!
+ * Play the transfer programmed by CRC_update_DMA: CITER minor loops of
+ * NBYTES from SADDR into CRC->DATA, then the interrupt of the channel.
+ */
+static void DMA_play(void)
+{
+	const uint32_t *source = (const uint32_t *) CRC_Model_dma.TCD[CRC_DMA_CH].SADDR;
+	uint32_t words = CRC_Model_dma.TCD[CRC_DMA_CH].CITER.ELINKNO * CRC_Model_dma.TCD[CRC_DMA_CH].NBYTES.MLNO / 4u;
+
+	CHECK(CRC_Model_dma.SERQ == CRC_DMA_CH, "CRC_DMA_CH requests enabled");
+	CHECK(CRC_Model_dma.TCD[CRC_DMA_CH].DADDR == (uint32_t) &CRC->DATAu.DATA, "TCD writes CRC->DATA");
+	while (words--) {
+		CRC->DATAu.DATA = *source++;
+	}
+	CRC_DMA_IRQ();
+}
+
+static void test_profile(CRC_Profile_id_t id)
+{
+	const CRC_Profile_t *profile = &CRC_Profiles[id];
+	const Expected_t *expected = &Expected[id];
+	CRC_Context_t ctx;
+	uint32_t result;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t mismatches = 0;
+	uint8_t i;
+
+	result = CRC_calculate(id, Check_string, 9);
+	printf("%-15s check 0x%08X\n", expected->name, (unsigned) result);
+	CHECK(result == expected->check, "check value of \"123456789\"");
+	CHECK(profile->check == expected->check, "check value of CRC_Profiles[]");
+	CHECK(CRC_profile_check(id) == 1u, "CRC_profile_check");
+
+	for (i = 0; i < VECTOR_COUNT; i++) {
+		CHECK(CRC_calculate(id, Vectors[i].data, Vectors[i].size) == expected->vector[i], "AUTOSAR test vector");
+		CHECK(reference(profile, Vectors[i].data, Vectors[i].size) == expected->vector[i], "reference on AUTOSAR test vector");
+	}
+
+	for (offset = 0; offset < 4u; offset++) {
+		for (size = 0; size <= 40u; size++) {
+			if (CRC_calculate(id, &Buffer[offset], size) != reference(profile, &Buffer[offset], size)) {
+				mismatches++;
+			}
+		}
+	}
+	CHECK(mismatches == 0u, "lengths 0..40 at every alignment");
+
+	for (offset = 0; offset < 4u; offset++) {
+		CRC_begin_profile(&ctx, id);
+		CRC_update(&ctx, &Buffer[offset], 3);
+		CRC_update_DMA(&ctx, &Buffer[offset + 3u], 37);
+		if (CRC_DMA_busy()) {
+			DMA_play();
+		}
+		CHECK(CRC_DMA_busy() == 0u, "DMA transfer completed");
+		CHECK(CRC_final(&ctx) == reference(profile, &Buffer[offset], 40), "CRC_update_DMA");
+	}
+}
+
+/* Two streams loaded in turns into the module */
+static void test_streams(void)
+{
+	CRC_Context_t crc32;
+	CRC_Context_t modbus;
+	uint32_t done;
+	uint32_t step;
+
+	printf("CRC32 and CRC16_MODBUS streams in turns\n");
+	CRC_begin_profile(&crc32, CRC_PROFILE_CRC32);
+	CRC_begin_profile(&modbus, CRC_PROFILE_CRC16_MODBUS);
+	for (done = 0, step = 1; done + step < sizeof(Buffer); done += step, step++) {
+		CRC_update(&crc32, &Buffer[done], step);
+		CRC_update(&modbus, &Buffer[1u + done], step);	/* Other alignment */
+	}
+	CHECK(CRC_final(&crc32) == reference(&CRC_Profiles[CRC_PROFILE_CRC32], Buffer, done), "CRC32 stream");
+	CHECK(CRC_final(&modbus) == reference(&CRC_Profiles[CRC_PROFILE_CRC16_MODBUS], &Buffer[1], done), "MODBUS stream");
+}
+
+int main(void)
+{
+	uint8_t letter = 'A';
+	uint8_t id;
+	uint32_t seed = 1;
+	uint32_t i;
+
+	for (i = 0; i < sizeof(Buffer); i++) {
+		seed = seed * 1103515245u + 12345u;
+		Buffer[i] = (uint8_t) (seed >> 16);
+	}
+	CRC_Model_reset();
+
+	for (id = 0; id < CRC_PROFILE_COUNT; id++) {
+		test_profile((CRC_Profile_id_t) id);
+	}
+	test_streams();
+
+	printf("CRC_32bits_calculate\n");
+	CHECK(CRC_32bits_calculate(&letter, 1) == 0xD3D99E8Bu, "\"A\" gives the standard CRC-32");
+	CHECK(CRC_32bits_calculate((uint8_t *) Check_string, 9) == 0xCBF43926u, "\"123456789\" gives the standard CRC-32");
+	CHECK(CRC_Model_writes(32) > 0u, "words written by the body loops");
+
+	printf("%s: %u failure(s)\n", (failures == 0u) ? "PASS" : "FAIL", (unsigned) failures);
+	return (failures == 0u) ? 0 : 1;
+}
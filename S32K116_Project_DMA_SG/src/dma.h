@@ -33,6 +33,8 @@
 #ifndef DMA_H_
 #define DMA_H_
 
+//#define DMA_INSTRUMENTATION	/* Count completions, decode errors and measure latency of the DMA channels */
+
 /* Structure with the TCD fields. */
 typedef struct
 {
@@ -62,15 +64,222 @@ typedef struct
 	};
 }TCD_t;
 
+/*!
+ * Compile-time TCD images
+ * ===================================================
+ * DMA_TCD_IMAGE expands to an initializer of a TCD_t, so complete channel
+ * configurations can be kept as const tables in flash and loaded into a
+ * channel with DMA_TCD_Load (or fetched by the eDMA itself through ESG).
+ * All arguments must be constant expressions.
+ */
+#define DMA_TCD_ATTR_SIZE(ssize, dsize)		(DMA_TCD_ATTR_SSIZE(ssize) | DMA_TCD_ATTR_DSIZE(dsize))	/* Src./Dest. 2**size bytes per transfer */
+#define DMA_TCD_ITER(iter)					DMA_TCD_CITER_ELINKNO_CITER(iter)	/* Major loop count, no minor loop link */
+#define DMA_TCD_ITER_LINK(iter, linkch)		(DMA_TCD_CITER_ELINKYES_CITER_LE(iter) |	\
+											 DMA_TCD_CITER_ELINKYES_ELINK_MASK |		\
+											 DMA_TCD_CITER_ELINKYES_LINKCH(linkch))	/* Major loop count, link to linkch after each minor loop */
+
+#define DMA_TCD_IMAGE(saddr, soff, daddr, doff, attr, nbytes, slast, dlastsga, iter, csr)	\
+{																					\
+	.SADDR         = (uint32_t)(saddr),												\
+	.SOFF          = (uint16_t)(soff),												\
+	.ATTR          = (uint16_t)(attr),												\
+	.NBYTES_MLNO   = (uint32_t)(nbytes),											\
+	.SLAST         = (uint32_t)(slast),												\
+	.DADDR         = (uint32_t)(daddr),												\
+	.DOFF          = (uint16_t)(doff),												\
+	.CITER_ELINKNO = (uint16_t)(iter),												\
+	.DLASTSGA      = (uint32_t)(dlastsga),											\
+	.CSR           = (uint16_t)(csr),												\
+	.BITER_ELINKNO = (uint16_t)(iter)												\
+}
+
+/*!
+ * Build time checks of a TCD image: the major loop count must fit in CITER
+ * (9 bits when minor loop linking is used, 15 bits otherwise), NBYTES and SOFF
+ * must be multiples of the source transfer size and SLAST must either keep the
+ * source address (0) or rewind exactly what the major loop advanced it.
+ */
+#define DMA_TCD_STATIC_CHECK(tag, soff, ssize, nbytes, iter, elink, slast)										\
+	_Static_assert(((iter) > 0) && ((iter) <= ((elink) ? 0x1FF : 0x7FFF)), "TCD " #tag ": CITER out of range");	\
+	_Static_assert(((nbytes) > 0) && (((nbytes) % (1 << (ssize))) == 0), "TCD " #tag ": NBYTES not multiple of SSIZE");	\
+	_Static_assert(((soff) % (1 << (ssize))) == 0, "TCD " #tag ": SOFF not multiple of SSIZE");					\
+	_Static_assert(((slast) == 0) || ((slast) == -((soff) * ((nbytes) >> (ssize)) * (iter))), "TCD " #tag ": SLAST does not match SOFF/CITER")
+
+#define DMA_TCD_NO_LINK		0xFFu	/* linkch of DMA_TCD_DEFINE: no minor loop channel link */
+
+/*!
+ * Defines a const TCD image "name" and its build time checks from one
+ * argument list, so the checks always see the values of the image. The image
+ * is aligned to 32 bytes, so it can also be the target of a Scatter Gather.
+ * linkch is the channel linked after each minor loop, or DMA_TCD_NO_LINK.
+ */
+#define DMA_TCD_DEFINE(name, saddr, soff, daddr, doff, ssize, dsize, nbytes, slast, dlastsga, iter, linkch, csr)	\
+	DMA_TCD_STATIC_CHECK(name, soff, ssize, nbytes, iter, ((linkch) != DMA_TCD_NO_LINK), slast);				\
+	static const TCD_t name __attribute__((aligned(32))) =														\
+		DMA_TCD_IMAGE(saddr, soff, daddr, doff, DMA_TCD_ATTR_SIZE(ssize, dsize), nbytes, slast, dlastsga,		\
+					  (((linkch) != DMA_TCD_NO_LINK) ? DMA_TCD_ITER_LINK(iter, linkch) : DMA_TCD_ITER(iter)), csr)
+
+_Static_assert(sizeof(TCD_t) == 32, "TCD_t must match the layout of DMA->TCD[n]");
+
+/* Channel link "microprogram": a sequence of moves executed by one channel. */
+typedef struct
+{
+	TCD_t * TCDm;		/* Array of TCDs in RAM (one per step), must be aligned to 32 bytes */
+	uint8_t size;		/* Capacity of the array */
+	uint8_t steps;		/* Steps added so far */
+	uint8_t ch;			/* DMA channel that executes the program */
+}DMA_Program_t;
+
+/* Priority classes of the channel manager, higher classes get higher DCHPRI. */
+typedef enum
+{
+	DMA_PRIO_BULK = 0,		/* Memory copies: lowest priority, can be preempted */
+	DMA_PRIO_NORMAL,		/* Neither preempts nor can be preempted */
+	DMA_PRIO_CRITICAL		/* Latency critical (ADC, CAN): highest priority, preempts bulk channels */
+}DMA_Priority_t;
+
+/* DCHPRI levels of each priority class: class c uses levels c * DMA_PRIO_BAND
+ * to (c + 1) * DMA_PRIO_BAND - 1, enough for every channel in one class. */
+#define DMA_PRIO_BAND	DMA_TCD_COUNT
+_Static_assert(((DMA_PRIO_CRITICAL + 1) * DMA_PRIO_BAND) <= (DMA_DCHPRI_CHPRI_MASK + 1u), "Priority bands exceed DCHPRI[CHPRI]");
+
+/* Entry of the channel allocation table. */
+typedef struct
+{
+	uint8_t used;					/* 1 when the channel has been allocated */
+	DMA_Priority_t priority;		/* Priority class of the channel */
+	dma_request_source_t source;	/* DMAMUX request routed to the channel (EDMA_REQ_DISABLED for linked channels) */
+}DMA_Channel_entry_t;
+
+/* Cost of one major loop of a TCD, computed by DMA_TCD_Stats. */
+typedef struct
+{
+	uint32_t bytes;			/* Bytes moved by the major loop */
+	uint32_t read_beats;	/* Source bus accesses (a 16-byte burst counts as four 32-bit beats) */
+	uint32_t write_beats;	/* Destination bus accesses */
+	uint32_t tcd_beats;		/* Bus accesses to fetch the next TCD (Scatter Gather) */
+	uint16_t minor_links;	/* Channel link events after minor loops */
+	uint16_t major_links;	/* Channel link events after the major loop */
+	uint16_t interrupts;	/* INTHALF / INTMAJOR requests */
+}DMA_TCD_Stats_t;
+
+#define DMA_CH_NONE		0xFFu	/* Returned by DMA_Channel_alloc when every channel is in use */
+
+/* Called with the half of the stream buffer that the eDMA has just filled. */
+typedef void (*DMA_Half_callback_t)(uint32_t volatile * samples, uint16_t count);
+
+#define DMA_MEMCPY_THRESHOLD	64	/* Copies shorter than this amount of bytes are done by the CPU */
+
+/* Descriptor ring used by the Scatter Gather streaming engine. */
+typedef struct
+{
+	TCD_t * TCDm;				/* Array of TCDs in RAM, must be aligned to 32 bytes */
+	uint8_t size;				/* Number of TCDs (blocks) in the ring */
+	uint8_t ch;					/* DMA channel that executes the ring */
+	uint8_t volatile head;		/* Index of the next block to be completed by the DMA */
+	uint32_t volatile blocks;	/* Amount of blocks completed since DMA_Ring_start */
+}DMA_Ring_t;
+
+#define DMA_SEQ_RESULT_CH	0	/* Channel moving ADC0 R[0] on each COCO request */
+#define DMA_SEQ_COMMAND_CH	1	/* Channel writing the next conversion into ADC0 SC1A */
+
+/* ADC conversion sequence executed by DMA_SEQ_RESULT_CH and DMA_SEQ_COMMAND_CH. */
+typedef struct
+{
+	const uint8_t * oversampling;	/* Conversions of each channel per sequence */
+	uint8_t count;					/* Channels of the list */
+	uint16_t size;					/* Conversions per sequence (sum of oversampling) */
+	uint32_t * commands;			/* SC1A value of each conversion */
+	uint32_t volatile * results;	/* Result of each conversion, channel buffers one after the other */
+}DMA_Sequence_t;
+
+#ifdef DMA_INSTRUMENTATION
+/* Decoded content of DMA->ES. */
+typedef struct
+{
+	uint32_t count;			/* Errors reported since DMA_Instr_init */
+	uint32_t ES;			/* Raw value of the last error status */
+	uint8_t channel;		/* Channel of the last error (ERRCHN) */
+	uint8_t source_bus;		/* SBE: bus error on a source read */
+	uint8_t dest_bus;		/* DBE: bus error on a destination write */
+	uint8_t scatter_gather;	/* SGE: DLASTSGA not aligned to 32 bytes */
+	uint8_t nbytes_citer;	/* NCE: NBYTES/CITER configuration error */
+	uint8_t dest_offset;	/* DOE: DOFF not multiple of DSIZE */
+	uint8_t dest_address;	/* DAE: DADDR not aligned to DSIZE */
+	uint8_t source_offset;	/* SOE: SOFF not multiple of SSIZE */
+	uint8_t source_address;	/* SAE: SADDR not aligned to SSIZE */
+	uint8_t priority;		/* CPE: channel priorities not unique */
+	uint8_t cancelled;		/* ECX: transfer cancelled */
+}DMA_Error_t;
+
+/* Activity of one channel. */
+typedef struct
+{
+	uint32_t completions;	/* Major loops completed */
+	uint32_t start;			/* Timestamp of the start (or of the previous completion) */
+	uint32_t latency;		/* Ticks from start to the last completion */
+	uint32_t latency_max;	/* Worst latency seen */
+}DMA_Channel_stats_t;
+
+/* Everything the instrumentation collects, kept in one place for a debugger. */
+typedef struct
+{
+	DMA_Channel_stats_t ch[DMA_TCD_COUNT];
+	DMA_Error_t error;
+}DMA_Instr_t;
+
+#define DMA_INSTR_LPIT_CH	3	/* LPIT0 channel used as free running timestamp */
+#define DMA_INSTR_START(ch)	DMA_Instr_start(ch)
+
+void DMA_Instr_init(uint8_t channels);
+uint32_t DMA_Instr_timestamp(void);
+void DMA_Instr_start(uint8_t ch);
+void DMA_Instr_done(uint8_t ch);
+void DMA_Instr_error(void);
+const DMA_Instr_t * DMA_Instr_get(void);
+#else
+#define DMA_INSTR_START(ch)
+#endif
+
 void DMA_init (void);
+uint8_t DMA_Channel_alloc(dma_request_source_t source, DMA_Priority_t priority);
+void DMA_Channel_reserve(uint8_t ch, dma_request_source_t source, DMA_Priority_t priority);
+void DMA_Channel_free(uint8_t ch);
+const DMA_Channel_entry_t * DMA_Channel_table(void);
 void DMA_TCD_init (void);
 void DMA_SG_init(void);
 void DMA_TCDm_config(uint32_t * buff_source, uint8_t SOFF, uint32_t * buff_dest, uint8_t DOFF, uint32_t size, TCD_t * TCDm);
 void DMA_TCD_Push(uint8_t ch, TCD_t * TCDm );
+void DMA_TCD_Load(uint8_t ch, const TCD_t * TCDm);
+void DMA_TCD_Read(uint8_t ch, TCD_t * TCDm);
+void DMA_TCD_Stats(const TCD_t * TCDm, uint8_t emlm, DMA_TCD_Stats_t * stats);
 void DMA_Config(uint32_t Destination[4]);
 void DMAMUX_LC_init(void);
 void DMA_TCD_LC_Config(void);
 void DMAMUX_FlexScan_init(void);
 void DMA_TCD_FlexScan_Config(void);
+void DMA_TCD_FlexScan_Stream_Config(uint32_t volatile * buffer, uint16_t size, DMA_Half_callback_t callback);
+void DMA_FlexScan_Stream_IRQ(void);
+void DMA_TCD_Deinterleave_Config(uint8_t ch, uint32_t volatile * source, uint8_t channels, uint32_t * dest, uint16_t depth);
+void DMA_Sequence_Config(DMA_Sequence_t * seq, const uint8_t * channels, const uint8_t * oversampling, uint8_t count, uint32_t * commands, uint32_t volatile * results);
+void DMA_Sequence_start(DMA_Sequence_t * seq);
+void DMA_Sequence_stop(void);
+uint32_t volatile * DMA_Sequence_buffer(const DMA_Sequence_t * seq, uint8_t index);
+uint16_t DMA_Sequence_average(const DMA_Sequence_t * seq, uint8_t index);
+void DMA_Program_init(DMA_Program_t * prog, uint8_t ch, TCD_t * TCDm, uint8_t size);
+void DMA_Program_move(DMA_Program_t * prog, void volatile * dest, void const volatile * source, uint8_t width, uint16_t count);
+void DMA_Program_write(DMA_Program_t * prog, uint32_t volatile * reg, uint32_t const * value);
+void DMA_Program_load(DMA_Program_t * prog);
+void DMA_Program_run(DMA_Program_t * prog);
+void DMA_Ring_init(DMA_Ring_t * ring, uint8_t ch, TCD_t * TCDm, uint8_t size);
+void DMA_Ring_block_config(DMA_Ring_t * ring, uint8_t index, uint32_t * buff_source, uint8_t SOFF, uint32_t * buff_dest, uint8_t DOFF, uint32_t size);
+void DMA_Ring_start(DMA_Ring_t * ring);
+void DMA_Ring_stop(DMA_Ring_t * ring);
+uint8_t DMA_Ring_block_done(DMA_Ring_t * ring);
+void DMA_memcpy_init(void);
+void DMA_memcpy(void * dest, const void * source, uint32_t count);
+void DMA_memset(void * dest, uint8_t value, uint32_t count);
+uint8_t DMA_memcpy_busy(void);
+void DMA_memcpy_wait(void);
 
 #endif /* DMA_H_ */
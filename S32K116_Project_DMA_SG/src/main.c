@@ -71,6 +71,10 @@ int main(void) {
 
 	S32_NVIC->ICPR[0] |= 1 << (0 % 32);  /* IRQ0-DMA0 ch0: clr any pending IRQ	*/
 	S32_NVIC->ISER[0] |= 1 << (0 % 32);  /* IRQ0-DMA0 ch0: enable IRQ 			*/
+#ifdef DMA_INSTRUMENTATION
+	DMA_Instr_init(1u << 0);			/* Start the timestamp counter and the error interrupt of CH0 */
+	S32_NVIC->ISER[0] |= 1 << (DMA_Error_IRQn % 32);  /* DMA error: enable IRQ */
+#endif
 
 	/*Start saving in the TCDm array the different TCDs to be used by the DMA*/
 	/*Save information in each TCDm with the source you would like	*/
@@ -81,6 +85,7 @@ int main(void) {
 	DMA_TCDm_config((uint32_t *)&TCD0_Source_2[0], SOFF, (uint32_t *)&TCD0_Destination[6], DOFF, SIZE2, &TCDm[1]); /* saving TCD config in RAM */
 
 	DMA_TCD_Push(0,&TCDm[0]);	/* "Push" TCD with index 0 to DMA channel 0 */
+	DMA_INSTR_START(0);			/* Latency reference for the first major loop */
 	DMA->SERQ = DMA_SERQ_SERQ(0);	/*	Enable DMA CH0 request	*/
 
     for (;;) {
@@ -97,7 +102,17 @@ int main(void) {
 
 void DMA0_IRQHandler (void)
 {
-	 DMA->CDNE |= DMA_CDNE_CADN(0x0);	/* Clear all Done status bit */
-	 DMA->CINT |= 0;					/* Clear Interrupt request */
+	 DMA->CDNE = DMA_CDNE_CDNE(0);	/* Clear Done status bit of CH0 */
+	 DMA->CINT = DMA_CINT_CINT(0);	/* Clear Interrupt request of CH0 */
+#ifdef DMA_INSTRUMENTATION
+	 DMA_Instr_done(0);				/* Count the major loop and its latency */
+#endif
 	 /* Set a breakpoint here and keep an eye on the TCD0_Destination Array inside the DMA driver */
 }
+
+#ifdef DMA_INSTRUMENTATION
+void DMA_Error_IRQHandler (void)
+{
+	 DMA_Instr_error();				/* Decode and clear the error, see DMA_Instr inside the DMA driver */
+}
+#endif
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*!
+ * Channel manager priorities
+ * ===================================================
+ * Reserves, allocates and frees channels while channel 0 keeps serving
+ * requests, and checks after every call:
+ *  - only the DCHPRI of the channel reserved has changed, so the levels of
+ *    the running channels are never rewritten;
+ *  - every channel has a different level (no ES[CPE] on the next request);
+ *  - critical channels rank above normal ones, normal above bulk.
+ *
+ * Build and run on a 32-bit host (the TCDs hold 32-bit addresses):
+ *   cc -m32 -std=gnu99 -DCPU_S32K116 -I. -I../include -I../src -include edma_model.h \
+ *      dma_channel_test.c edma_model.c ../src/dma.c -o dma_channel_test && ./dma_channel_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "edma_model.h"
+
+static uint8_t Source = 0x5A;
+static uint8_t Dest;
+static uint8_t Snapshot[DMA_TCD_COUNT];
+static uint32_t failures;
+
+#define CHECK(cond, what)	check((cond) ? 1u : 0u, what, __LINE__)
+
+static void check(uint8_t ok, const char * what, int line)
+{
+	if (!ok) {
+		failures++;
+		printf("  FAIL line %d: %s\n", line, what);
+	}
+}
+
+static uint8_t level(uint8_t ch)
+{
+	return DMA->DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)] & DMA_DCHPRI_CHPRI_MASK;
+}
+
+static void snapshot(void)
+{
+	uint8_t ch;
+
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		Snapshot[ch] = DMA->DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)];
+	}
+}
+
+/*!
+ * Check the priorities after a call that may only change channel "changed"
+ * (DMA_CH_NONE: no channel may change), then serve one request of channel 0.
+ */
+static void check_priorities(const char * step, uint8_t changed)
+{
+	const DMA_Channel_entry_t * table = DMA_Channel_table();
+	uint8_t ch;
+	uint8_t other;
+	uint8_t ok = 1;
+
+	printf("%-28s levels", step);
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		printf(" %2u%c", level(ch), table[ch].used ? "bnc"[table[ch].priority] : '-');
+		if ((ch != changed) && (DMA->DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)] != Snapshot[ch])) {
+			ok = 0;
+		}
+	}
+	printf("\n");
+	CHECK(ok, "only the reserved channel is written");
+
+	ok = 1;
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		for (other = 0; other < DMA_TCD_COUNT; other++) {
+			if ((other != ch) && (level(other) == level(ch))) {
+				ok = 0;		/* Not unique */
+			}
+			if (table[ch].used && table[other].used && (table[ch].priority > table[other].priority) &&
+				(level(ch) <= level(other))) {
+				ok = 0;		/* Class order */
+			}
+		}
+	}
+	CHECK(ok, "unique levels in class order");
+
+	Dest = 0;
+	CHECK(EDMA_Model_request(0), "channel 0 request");
+	CHECK(Dest == 0x5Au, "channel 0 keeps working");
+	snapshot();
+}
+
+int main(void)
+{
+	TCD_t TCDm;
+	uint8_t ch;
+
+	EDMA_Model_reset();
+	EDMA_Model_region(&Source, 1);
+	EDMA_Model_region(&Dest, 1);
+	snapshot();
+
+	/* Channel 0: critical, one byte per request, kept enabled */
+	DMA_Channel_reserve(0, EDMA_REQ_ADC0, DMA_PRIO_CRITICAL);
+	DMA_TCDm_config((uint32_t *) &Source, 0, (uint32_t *) &Dest, 0, 1, &TCDm);
+	TCDm.CSR &= ~(DMA_TCD_CSR_DREQ(1) | DMA_TCD_CSR_INTMAJOR(1));
+	DMA_TCD_Load(0, &TCDm);
+	DMA->SERQ = DMA_SERQ_SERQ(0);
+	EDMA_Model_sync();
+	check_priorities("reserve 0 critical", 0);
+
+	ch = DMA_Channel_alloc(EDMA_REQ_DMAMUX_ALWAYS_ENABLED1, DMA_PRIO_BULK);
+	CHECK(ch == 1u, "first free channel");
+	check_priorities("alloc bulk", ch);
+	ch = DMA_Channel_alloc(EDMA_REQ_DISABLED, DMA_PRIO_NORMAL);
+	check_priorities("alloc normal", ch);
+	ch = DMA_Channel_alloc(EDMA_REQ_LPUART0_RX, DMA_PRIO_CRITICAL);
+	check_priorities("alloc critical", ch);
+	CHECK(DMA_Channel_alloc(EDMA_REQ_DISABLED, DMA_PRIO_BULK) == DMA_CH_NONE, "no channel left");
+
+	DMA_Channel_free(1);
+	check_priorities("free 1", DMA_CH_NONE);
+	DMA_Channel_reserve(1, EDMA_REQ_DISABLED, DMA_PRIO_CRITICAL);
+	check_priorities("reserve 1 critical", 1);
+	DMA_Channel_free(2);
+	check_priorities("free 2", DMA_CH_NONE);
+	DMA_Channel_reserve(2, EDMA_REQ_DISABLED, DMA_PRIO_CRITICAL);
+	check_priorities("reserve 2 critical", 2);
+	for (ch = 1; ch < DMA_TCD_COUNT; ch++) {
+		DMA_Channel_free(ch);
+		check_priorities("free", DMA_CH_NONE);
+	}
+	for (ch = 1; ch < DMA_TCD_COUNT; ch++) {
+		DMA_Channel_reserve(ch, EDMA_REQ_DISABLED, DMA_PRIO_BULK);
+		check_priorities("reserve bulk", ch);
+	}
+
+	CHECK(EDMA_Model_errors() == 0u, "no eDMA error (ES[CPE])");
+	printf("%s: %u failure(s)\n", (failures == 0u) ? "PASS" : "FAIL", (unsigned) failures);
+	return (failures == 0u) ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*!
+ * Regression check of the TCD images of the dma driver
+ * ===================================================
+ * Every feature is configured through the driver (DMA_TCD_init,
+ * DMA_TCD_LC_Config, DMA_TCD_FlexScan_Config, DMA_Config,
+ * DMA_TCD_Deinterleave_Config), run on the eDMA model and checked twice:
+ * the data must land where the feature promises, and what the model counted
+ * (bytes, bus beats, links, interrupts) must match DMA_TCD_Stats of the TCD
+ * read back from the channel.
+ *
+ * Build and run on a 32-bit host (the TCDs hold 32-bit addresses):
+ *   cc -m32 -std=gnu99 -DCPU_S32K116 -I. -I../include -I../src -include edma_model.h \
+ *      dma_images_test.c edma_model.c ../src/dma.c -o dma_images_test && ./dma_images_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "edma_model.h"
+
+extern uint8_t TCD0_Source[12];
+extern uint8_t volatile TCD0_Dest;
+extern uint8_t volatile TCD_LC_Dest[11];
+extern uint32_t volatile ADC_SC1A_CH[3];
+extern uint32_t volatile ADC_Results[16];
+
+static uint32_t failures;
+
+#define CHECK(cond, what)	check((cond) ? 1u : 0u, what, __LINE__)
+
+static void check(uint8_t ok, const char * what, int line)
+{
+	if (!ok) {
+		failures++;
+		printf("  FAIL line %d: %s\n", line, what);
+	}
+}
+
+/* Write a result register, read-only for the driver. */
+static void ADC_result_set(uint8_t index, uint32_t value)
+{
+	*(uint32_t volatile *) &EDMA_Model_adc0.R[index] = value;
+}
+
+/*!
+ * What the model counted on a channel must be "majors" times what
+ * DMA_TCD_Stats predicts for one major loop of its TCD.
+ */
+static void check_stats(const char * name, uint8_t ch, const TCD_t * TCDm, uint8_t emlm, uint32_t majors)
+{
+	DMA_TCD_Stats_t expected;
+	const DMA_TCD_Stats_t * seen = EDMA_Model_stats(ch);
+
+	DMA_TCD_Stats(TCDm, emlm, &expected);
+	printf("  %-14s CH%u: %3u bytes, %3u/%3u beats, %2u TCD beats, %2u/%u links, %u IRQ\n", name, ch,
+		   (unsigned) seen->bytes, (unsigned) seen->read_beats, (unsigned) seen->write_beats,
+		   (unsigned) seen->tcd_beats, seen->minor_links, seen->major_links, seen->interrupts);
+
+	CHECK(EDMA_Model_majors(ch) == majors, "major loops");
+	CHECK(seen->bytes == expected.bytes * majors, "bytes");
+	CHECK(seen->read_beats == expected.read_beats * majors, "read beats");
+	CHECK(seen->write_beats == expected.write_beats * majors, "write beats");
+	CHECK(seen->tcd_beats == expected.tcd_beats * majors, "TCD beats");
+	CHECK(seen->minor_links == expected.minor_links * majors, "minor links");
+	CHECK(seen->major_links == expected.major_links * majors, "major links");
+	CHECK(seen->interrupts == expected.interrupts * majors, "interrupts");
+}
+
+static void enable_requests(uint8_t ch)
+{
+	DMA->SERQ = DMA_SERQ_SERQ(ch);
+	EDMA_Model_sync();
+}
+
+/* TCD_init: 11 bytes to a single destination, requests disabled at the end (DREQ). */
+static void test_TCD_init(void)
+{
+	TCD_t TCDm;
+	uint8_t requests = 0;
+
+	printf("TCD_init\n");
+	EDMA_Model_reset();
+	EDMA_Model_region(TCD0_Source, sizeof(TCD0_Source));
+	EDMA_Model_region(&TCD0_Dest, 1);
+
+	DMA_TCD_init();
+	DMA_TCD_Read(0, &TCDm);
+	enable_requests(0);
+	while (EDMA_Model_request(0) && (requests < 20u)) {
+		requests++;
+	}
+
+	CHECK(requests == 11u, "one request per byte, then DREQ stops the channel");
+	CHECK(TCD0_Dest == 'd', "last byte of \"Hello World\"");
+	CHECK(DMA->TCD[0].SADDR == (uint32_t) &TCD0_Source[0], "SLAST rewinds the source");
+	CHECK((DMA->TCD[0].CSR & DMA_TCD_CSR_DONE_MASK) != 0u, "DONE");
+	check_stats("TCD_init", 0, &TCDm, 0, 1);
+}
+
+/* LC_CH0/LC_CH1: CH0 links to CH1 after each of its minor loops but the last. */
+static void test_LC(void)
+{
+	TCD_t TCDm[2];
+	uint8_t i;
+
+	printf("LC_CH0/LC_CH1\n");
+	EDMA_Model_reset();
+	EDMA_Model_region(TCD0_Source, sizeof(TCD0_Source));
+	EDMA_Model_region(TCD_LC_Dest, sizeof(TCD_LC_Dest));
+	memset((void *) TCD_LC_Dest, 0, sizeof(TCD_LC_Dest));
+
+	DMAMUX_LC_init();
+	DMA_TCD_LC_Config();
+	DMA_TCD_Read(0, &TCDm[0]);
+	DMA_TCD_Read(1, &TCDm[1]);
+	enable_requests(0);
+	for (i = 0; i < 6u; i++) {
+		CHECK(EDMA_Model_request(0), "CH0 request");
+	}
+
+	CHECK(memcmp((const void *) TCD_LC_Dest, "Hello World", 11) == 0, "\"Hello World\" built by both channels");
+	CHECK(EDMA_Model_request(0) == 0u, "CH0 stopped by DREQ");
+	CHECK((DMA->INT & (1u << 1)) != 0u, "CH1 INTMAJOR");
+	CHECK(DMAMUX->CHCFG[0] == (DMAMUX_CHCFG_SOURCE(EDMA_REQ_DMAMUX_ALWAYS_ENABLED0) | DMAMUX_CHCFG_ENBL_MASK), "CH0 always enabled");
+	check_stats("LC_CH0", 0, &TCDm[0], 0, 1);
+	check_stats("LC_CH1", 1, &TCDm[1], 0, 1);
+}
+
+/* FlexScan_CH0/CH1: CH0 moves R[0] on each COCO, CH1 writes the next channel into SC1A. */
+static void test_FlexScan(void)
+{
+	TCD_t TCDm[2];
+	uint8_t i;
+	uint8_t ok = 1;
+
+	printf("FlexScan_CH0/FlexScan_CH1\n");
+	EDMA_Model_reset();
+	EDMA_Model_region(ADC_SC1A_CH, sizeof(ADC_SC1A_CH));
+	EDMA_Model_region(ADC_Results, sizeof(ADC_Results));
+	memset((void *) ADC_Results, 0, sizeof(ADC_Results));
+
+	DMAMUX_FlexScan_init();
+	DMA_TCD_FlexScan_Config();
+	DMA_TCD_Read(0, &TCDm[0]);
+	DMA_TCD_Read(1, &TCDm[1]);
+	enable_requests(0);
+
+	ADC0->SC1[0] = ADC_SC1_ADCH(ADC_SC1A_CH[2]);	/* First conversion, as the scan wraps to it */
+	for (i = 0; i < 12u; i++) {
+		ADC_result_set(0, 1000u + (ADC0->SC1[0] & ADC_SC1_ADCH_MASK));	/* Conversion of the channel in SC1A */
+		CHECK(EDMA_Model_request(0), "CH0 request on COCO");
+	}
+	for (i = 0; i < 12u; i++) {
+		if (ADC_Results[i] != 1000u + ADC_SC1A_CH[(i + 2u) % 3u]) {
+			ok = 0;
+		}
+	}
+
+	CHECK(ok, "ADC_Results follow the ADC_SC1A_CH list");
+	CHECK(DMA->TCD[0].DADDR == (uint32_t) &ADC_Results[0], "CH0 back to ADC_Results[0]");
+	CHECK(DMA->TCD[1].SADDR == (uint32_t) &ADC_SC1A_CH[0], "CH1 back to ADC_SC1A_CH[0]");
+	CHECK((DMA->INT & (1u << 0)) != 0u, "CH0 INTMAJOR");
+	check_stats("FlexScan_CH0", 0, &TCDm[0], 0, 1);
+	check_stats("FlexScan_CH1", 1, &TCDm[1], 0, 4);	/* 11 minor links + 1 major link = 4 loops of 3 */
+}
+
+/* DMA_Config: CH3 moves 10 x 16 bits of R[4..8] on COCO and links to CH1 at the end. */
+static void test_DMA_Config(void)
+{
+	uint32_t Destination[5];	/* The major loop moves 20 bytes: one word more than the Destination[4] of the prototype */
+	uint8_t link_source = 0x5A;
+	uint8_t link_dest = 0;
+	TCD_t TCDm[2];
+	uint8_t i;
+
+	printf("DMA_Config\n");
+	EDMA_Model_reset();
+	EDMA_Model_region(Destination, sizeof(Destination));
+	EDMA_Model_region(&link_source, 1);
+	EDMA_Model_region(&link_dest, 1);
+	memset(Destination, 0, sizeof(Destination));
+	for (i = 0; i < 5u; i++) {
+		ADC_result_set(4u + i, 0x00010001u * (i + 1u));
+	}
+
+	DMA_TCDm_config((uint32_t *) &link_source, 0, (uint32_t *) &link_dest, 0, 1, &TCDm[1]);	/* Stand-in for the linked channel */
+	DMA_TCD_Load(1, &TCDm[1]);
+	DMA_Config(Destination);
+	DMA_TCD_Read(3, &TCDm[0]);
+	EDMA_Model_sync();
+	for (i = 0; i < 10u; i++) {
+		CHECK(EDMA_Model_request(3), "CH3 request on COCO");
+	}
+
+	CHECK(memcmp(Destination, (const void *) &ADC0->R[4], sizeof(Destination)) == 0, "R[4..8] copied");
+	CHECK(link_dest == 0x5Au, "CH1 started by the major link");
+	CHECK(DMA->TCD[3].DADDR == (uint32_t) &Destination[0], "DLASTSGA rewinds the destination");
+	check_stats("DMA_Config", 3, &TCDm[0], 0, 1);
+	check_stats("linked CH1", 1, &TCDm[1], 0, 1);
+}
+
+/* Deinterleave: 4 result registers scattered into 4 arrays of 8 samples, EMLM on. */
+static void test_Deinterleave(void)
+{
+	uint32_t dest[4][8];
+	uint32_t errors;
+	uint8_t slot;
+	uint8_t sample;
+	uint8_t pass;
+	uint8_t ok = 1;
+	TCD_t TCDm;
+	DMA_TCD_Stats_t no_emlm;
+
+	printf("Deinterleave\n");
+	EDMA_Model_reset();
+	EDMA_Model_region(dest, sizeof(dest));
+
+	DMA_TCD_Deinterleave_Config(2, (uint32_t volatile *) &ADC0->R[2], 4, &dest[0][0], 8);
+	DMA_TCD_Read(2, &TCDm);
+	enable_requests(2);
+
+	for (pass = 0; pass < 2u; pass++) {
+		memset(dest, 0, sizeof(dest));
+		for (sample = 0; sample < 8u; sample++) {
+			for (slot = 0; slot < 4u; slot++) {
+				ADC_result_set(2u + slot, (pass * 1000u) + (sample * 10u) + slot);	/* Results of one scan */
+			}
+			CHECK(EDMA_Model_request(2), "request per scan");
+		}
+		for (slot = 0; slot < 4u; slot++) {
+			for (sample = 0; sample < 8u; sample++) {
+				if (dest[slot][sample] != (pass * 1000u) + (sample * 10u) + slot) {
+					ok = 0;
+				}
+			}
+		}
+	}
+
+	CHECK(ok, "dest[slot][sample] on both passes");
+	CHECK(DMA->TCD[2].DADDR == (uint32_t) &dest[0][0], "back to dest[0][0]");
+	CHECK(DMA->TCD[2].SADDR == (uint32_t) &ADC0->R[2], "source wrapped by SMOD");
+	CHECK((DMA->ERQ & (1u << 2)) != 0u, "channel kept active");
+	check_stats("Deinterleave", 2, &TCDm, 1, 2);
+
+	DMA_TCD_Stats(&TCDm, 0, &no_emlm);
+	CHECK(no_emlm.bytes != 16u * 8u, "NBYTES depends on EMLM, DMA_TCD_Stats must be told");
+
+	errors = EDMA_Model_asserts();
+	DMA_TCD_Deinterleave_Config(2, (uint32_t volatile *) &ADC0->R[2], 4, &dest[0][0], 8192);
+	CHECK(EDMA_Model_asserts() == errors + 1u, "depth > 8191 rejected (DOFF)");
+	DMA_TCD_Deinterleave_Config(2, (uint32_t volatile *) &ADC0->SC1[0], 32, &dest[0][0], 8191);
+	CHECK(EDMA_Model_asserts() == errors + 2u, "channels * depth > 131072 rejected (MLOFF)");
+	DMA_TCD_Deinterleave_Config(2, (uint32_t volatile *) &ADC0->SC1[0], 16, &dest[0][0], 8191);
+	CHECK(EDMA_Model_asserts() == errors + 2u, "channels * depth = 131056 accepted");
+}
+
+/* Stream buffer of DMA_TCD_FlexScan_Stream_Config: each half must hold whole scans. */
+static void test_FlexScan_Stream_size(void)
+{
+	static uint32_t volatile buffer[24];
+	uint32_t errors;
+
+	printf("FlexScan stream size\n");
+	EDMA_Model_reset();
+	errors = EDMA_Model_asserts();
+	DMA_TCD_FlexScan_Stream_Config(buffer, 24, 0);
+	CHECK(EDMA_Model_asserts() == errors, "24 samples accepted");
+	DMA_TCD_FlexScan_Stream_Config(buffer, 20, 0);
+	CHECK(EDMA_Model_asserts() == errors + 1u, "20 samples rejected (halves of 10 split a scan of 3)");
+}
+
+int main(void)
+{
+	test_TCD_init();
+	test_LC();
+	test_FlexScan();
+	test_DMA_Config();
+	test_Deinterleave();
+	test_FlexScan_Stream_size();
+
+	CHECK(EDMA_Model_errors() == 0u, "no eDMA error");
+	printf("%s: %u failure(s)\n", (failures == 0u) ? "PASS" : "FAIL", (unsigned) failures);
+	return (failures == 0u) ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*!
+ * Scatter Gather ring walk
+ * ===================================================
+ * Builds a ring of three blocks with DMA_Ring_init/DMA_Ring_block_config,
+ * starts it with DMA_Ring_start and runs it on the eDMA model for two laps,
+ * serving every major loop interrupt with DMA_Ring_block_done as the DMA
+ * interrupt handler would. Checked on every block: the index returned by
+ * DMA_Ring_block_done, the data of the block, and that the TCD fetched by
+ * ESG is the next one of the ring. At the end the counters of the model
+ * must match DMA_TCD_Stats of the ring TCDs, including the 8 beats of each
+ * TCD fetch.
+ *
+ * Build and run on a 32-bit host (the TCDs hold 32-bit addresses):
+ *   cc -m32 -std=gnu99 -DCPU_S32K116 -I. -I../include -I../src -include edma_model.h \
+ *      dma_ring_test.c edma_model.c ../src/dma.c -o dma_ring_test && ./dma_ring_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "edma_model.h"
+
+#define RING_CH		0u
+#define RING_SIZE	3u
+#define RING_LAPS	2u
+
+static TCD_t Ring_TCD[RING_SIZE] __attribute__ ((aligned(32)));	/* ESG requires 32-byte aligned TCDs */
+static uint8_t Ring_Source[] = "Hello World!!!";
+static uint8_t Ring_Dest[14];
+static const uint8_t Ring_Offset[RING_SIZE + 1u] = {0, 6, 11, 14};	/* "Hello ", "World", "!!!" */
+
+static uint32_t failures;
+
+#define CHECK(cond, what)	check((cond) ? 1u : 0u, what, __LINE__)
+
+static void check(uint8_t ok, const char * what, int line)
+{
+	if (!ok) {
+		failures++;
+		printf("  FAIL line %d: %s\n", line, what);
+	}
+}
+
+int main(void)
+{
+	DMA_Ring_t ring;
+	DMA_TCD_Stats_t lap;
+	DMA_TCD_Stats_t block;
+	const DMA_TCD_Stats_t * seen;
+	uint8_t index;
+	uint8_t done;
+	uint8_t next;
+	uint8_t lap_count;
+	uint8_t requests;
+	uint32_t errors;
+	char text[sizeof(Ring_Dest) + 1u];
+
+	EDMA_Model_reset();
+	EDMA_Model_region(Ring_TCD, sizeof(Ring_TCD));
+	EDMA_Model_region(Ring_Source, sizeof(Ring_Source));
+	EDMA_Model_region(Ring_Dest, sizeof(Ring_Dest));
+
+	DMA_Ring_init(&ring, RING_CH, Ring_TCD, RING_SIZE);
+	memset(&lap, 0, sizeof(lap));
+	for (index = 0; index < RING_SIZE; index++) {
+		DMA_Ring_block_config(&ring, index, (uint32_t *) &Ring_Source[Ring_Offset[index]], 1,
+							  (uint32_t *) &Ring_Dest[Ring_Offset[index]], 1, Ring_Offset[index + 1u] - Ring_Offset[index]);
+		DMA_TCD_Stats(&Ring_TCD[index], 0, &block);
+		lap.bytes       += block.bytes;
+		lap.read_beats  += block.read_beats;
+		lap.write_beats += block.write_beats;
+		lap.tcd_beats   += block.tcd_beats;
+		lap.interrupts  += block.interrupts;
+	}
+	DMA_Ring_start(&ring);
+	EDMA_Model_sync();
+
+	for (lap_count = 0; lap_count < RING_LAPS; lap_count++) {
+		printf("lap %u\n", lap_count);
+		memset(Ring_Dest, 0, sizeof(Ring_Dest));
+		for (index = 0; index < RING_SIZE; index++) {
+			requests = 0;
+			while (((DMA->INT & (1u << RING_CH)) == 0u) && (requests < 32u)) {
+				CHECK(EDMA_Model_request(RING_CH), "ring channel request");	/* Always enabled source */
+				requests++;
+			}
+			done = DMA_Ring_block_done(&ring);	/* DMA interrupt handler */
+			EDMA_Model_sync();
+			next = (uint8_t)((done + 1u) % RING_SIZE);
+			memset(text, 0, sizeof(text));
+			memcpy(text, &Ring_Dest[Ring_Offset[done]], Ring_Offset[done + 1u] - Ring_Offset[done]);
+			printf("  block %u: %u minor loops, \"%s\"\n", done, requests, text);
+
+			CHECK(done == index, "blocks completed in ring order");
+			CHECK(requests == (uint8_t)(Ring_Offset[done + 1u] - Ring_Offset[done]), "one minor loop per byte");
+			CHECK(memcmp(&Ring_Dest[Ring_Offset[done]], &Ring_Source[Ring_Offset[done]], requests) == 0, "block data");
+			CHECK((DMA->INT & (1u << RING_CH)) == 0u, "interrupt cleared by DMA_Ring_block_done");
+			CHECK(DMA->TCD[RING_CH].SADDR == Ring_TCD[next].SADDR, "ESG fetched the next source");
+			CHECK(DMA->TCD[RING_CH].DADDR == Ring_TCD[next].DADDR, "ESG fetched the next destination");
+			CHECK(DMA->TCD[RING_CH].DLASTSGA == (uint32_t) &Ring_TCD[(next + 1u) % RING_SIZE], "DLASTSGA points to the block after");
+			CHECK((DMA->ERQ & (1u << RING_CH)) != 0u, "ring channel kept enabled (DREQ = 0)");
+		}
+		CHECK(memcmp(Ring_Dest, Ring_Source, sizeof(Ring_Dest)) == 0, "whole lap");
+	}
+
+	CHECK(ring.blocks == RING_SIZE * RING_LAPS, "blocks counted");
+	CHECK(ring.head == 0u, "head wrapped to the first block");
+
+	seen = EDMA_Model_stats(RING_CH);
+	printf("ring CH%u: %u bytes, %u/%u beats, %u TCD beats, %u IRQ\n", RING_CH, (unsigned) seen->bytes,
+		   (unsigned) seen->read_beats, (unsigned) seen->write_beats, (unsigned) seen->tcd_beats, seen->interrupts);
+	CHECK(seen->bytes == lap.bytes * RING_LAPS, "bytes");
+	CHECK(seen->read_beats == lap.read_beats * RING_LAPS, "read beats");
+	CHECK(seen->write_beats == lap.write_beats * RING_LAPS, "write beats");
+	CHECK(seen->tcd_beats == RING_SIZE * RING_LAPS * (sizeof(TCD_t) / 4u), "one TCD fetch per block");
+	CHECK(seen->tcd_beats == lap.tcd_beats * RING_LAPS, "TCD beats");
+	CHECK(seen->interrupts == lap.interrupts * RING_LAPS, "interrupts");
+
+	DMA_Ring_stop(&ring);
+	EDMA_Model_sync();
+	CHECK(EDMA_Model_request(RING_CH) == 0u, "no request served after DMA_Ring_stop");
+
+	errors = EDMA_Model_asserts();
+	DMA_Ring_init(&ring, RING_CH, (TCD_t *) ((uint8_t *) Ring_TCD + 16), RING_SIZE);
+	CHECK(EDMA_Model_asserts() == errors + 1u, "misaligned ring rejected");
+
+	CHECK(EDMA_Model_errors() == 0u, "no eDMA error");
+	printf("%s: %u failure(s)\n", (failures == 0u) ? "PASS" : "FAIL", (unsigned) failures);
+	return (failures == 0u) ? 0 : 1;
+}
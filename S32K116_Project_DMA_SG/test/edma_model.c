@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "edma_model.h"
+
+DMA_Type EDMA_Model_dma __attribute__((aligned(4096)));		/*< Registers seen by the driver as DMA */
+DMAMUX_Type EDMA_Model_dmamux __attribute__((aligned(4096)));
+ADC_Type EDMA_Model_adc0 __attribute__((aligned(4096)));	/*< Result and SC1 registers moved by the FlexScan channels */
+PCC_Type EDMA_Model_pcc __attribute__((aligned(4096)));
+SIM_Type EDMA_Model_sim __attribute__((aligned(4096)));
+LPIT_Type EDMA_Model_lpit0 __attribute__((aligned(4096)));
+
+typedef struct
+{
+	uint32_t base;
+	uint32_t size;
+}EDMA_Region_t;
+
+static EDMA_Region_t EDMA_regions[EDMA_MODEL_REGIONS];
+static uint8_t EDMA_region_count;
+static DMA_TCD_Stats_t EDMA_stats[DMA_TCD_COUNT];
+static uint32_t EDMA_major_count[DMA_TCD_COUNT];
+static uint32_t EDMA_error_count;
+static uint32_t EDMA_assert_count;
+
+#define EDMA_NOP	0x80u	/* NOP bit of the command registers: nothing written since the last sync */
+
+/* Registers read-only for the driver are written by the model through these. */
+#define EDMA_REG32(reg)	(*(uint32_t volatile *) &(reg))
+
+void EDMA_Model_assert(const char * expr, const char * file, int line)
+{
+	EDMA_assert_count++;
+	printf("  DEV_ASSERT(%s) failed at %s:%d\n", expr, file, line);
+}
+
+/*!
+ * Model reset
+ * ===================================================
+ * Registers at their reset value, no memory region, counters cleared. The
+ * host copy of ADC0 is always accessible.
+ */
+void EDMA_Model_reset(void)
+{
+	uint8_t ch;
+
+	memset((void *) &EDMA_Model_dma, 0, sizeof(EDMA_Model_dma));
+	memset((void *) &EDMA_Model_dmamux, 0, sizeof(EDMA_Model_dmamux));
+	memset((void *) &EDMA_Model_adc0, 0, sizeof(EDMA_Model_adc0));
+	memset((void *) &EDMA_Model_pcc, 0, sizeof(EDMA_Model_pcc));
+	memset((void *) &EDMA_Model_sim, 0, sizeof(EDMA_Model_sim));
+	memset((void *) &EDMA_Model_lpit0, 0, sizeof(EDMA_Model_lpit0));
+
+	EDMA_Model_dma.CEEI = EDMA_NOP;
+	EDMA_Model_dma.SEEI = EDMA_NOP;
+	EDMA_Model_dma.CERQ = EDMA_NOP;
+	EDMA_Model_dma.SERQ = EDMA_NOP;
+	EDMA_Model_dma.CDNE = EDMA_NOP;
+	EDMA_Model_dma.SSRT = EDMA_NOP;
+	EDMA_Model_dma.CERR = EDMA_NOP;
+	EDMA_Model_dma.CINT = EDMA_NOP;
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		EDMA_Model_dma.DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)] = DMA_DCHPRI_CHPRI(ch);	/* Reset value */
+	}
+
+	EDMA_region_count = 0;
+	EDMA_Model_region(&EDMA_Model_adc0, sizeof(EDMA_Model_adc0));
+	EDMA_Model_clear_stats();
+	EDMA_error_count = 0;
+	EDMA_assert_count = 0;
+}
+
+/*!
+ * Declare a block of memory the channels may read or write. Any other
+ * access is a bus error (ES[SBE] / ES[DBE]).
+ */
+void EDMA_Model_region(const volatile void * base, uint32_t size)
+{
+	if (EDMA_region_count < EDMA_MODEL_REGIONS) {
+		EDMA_regions[EDMA_region_count].base = (uint32_t) base;
+		EDMA_regions[EDMA_region_count].size = size;
+		EDMA_region_count++;
+	}
+}
+
+static uint8_t EDMA_mapped(uint32_t addr, uint32_t size)
+{
+	uint8_t i;
+
+	for (i = 0; i < EDMA_region_count; i++) {
+		if ((addr >= EDMA_regions[i].base) && ((addr - EDMA_regions[i].base) + size <= EDMA_regions[i].size)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*!
+ * Channel error: the channel stops, ERR and ES report it as the eDMA does.
+ */
+static void EDMA_error(uint8_t ch, uint32_t es)
+{
+	EDMA_REG32(EDMA_Model_dma.ES) = es | DMA_ES_ERRCHN(ch) | DMA_ES_VLD_MASK;
+	EDMA_Model_dma.ERR |= 1u << ch;
+	EDMA_Model_dma.TCD[ch].CSR &= (uint16_t) ~(DMA_TCD_CSR_ACTIVE_MASK | DMA_TCD_CSR_START_MASK);
+	EDMA_error_count++;
+	printf("  eDMA error on channel %u, ES = 0x%08X\n", ch, (unsigned) EDMA_Model_dma.ES);
+}
+
+/* Address after an offset, the low "mod" bits wrap when a modulo is set. */
+static uint32_t EDMA_next(uint32_t addr, int32_t offset, uint8_t mod)
+{
+	uint32_t next = addr + (uint32_t) offset;
+
+	if (mod != 0u) {
+		uint32_t mask = (1u << mod) - 1u;
+		next = (addr & ~mask) | (next & mask);
+	}
+	return next;
+}
+
+static void EDMA_channel_start(uint8_t ch);
+
+/*!
+ * One service of a channel: a complete minor loop, then the updates of the
+ * end of the minor loop or of the major loop.
+ */
+static void EDMA_service(uint8_t ch)
+{
+	uint8_t buffer[32];
+	DMA_TCD_Stats_t * stats = &EDMA_stats[ch];
+	uint16_t attr = EDMA_Model_dma.TCD[ch].ATTR;
+	uint8_t ssize = (uint8_t)((attr & DMA_TCD_ATTR_SSIZE_MASK) >> DMA_TCD_ATTR_SSIZE_SHIFT);
+	uint8_t dsize = (uint8_t)((attr & DMA_TCD_ATTR_DSIZE_MASK) >> DMA_TCD_ATTR_DSIZE_SHIFT);
+	uint8_t smod = (uint8_t)((attr & DMA_TCD_ATTR_SMOD_MASK) >> DMA_TCD_ATTR_SMOD_SHIFT);
+	uint8_t dmod = (uint8_t)((attr & DMA_TCD_ATTR_DMOD_MASK) >> DMA_TCD_ATTR_DMOD_SHIFT);
+	uint32_t sbytes = 1u << ssize;
+	uint32_t dbytes = 1u << dsize;
+	uint32_t chunk = (sbytes > dbytes) ? sbytes : dbytes;
+	int32_t soff = (int16_t) EDMA_Model_dma.TCD[ch].SOFF;
+	int32_t doff = (int16_t) EDMA_Model_dma.TCD[ch].DOFF;
+	uint32_t saddr = EDMA_Model_dma.TCD[ch].SADDR;
+	uint32_t daddr = EDMA_Model_dma.TCD[ch].DADDR;
+	uint32_t raw = EDMA_Model_dma.TCD[ch].NBYTES.MLNO;
+	uint32_t nbytes = raw;
+	int32_t mloff = 0;
+	uint8_t smloe = 0;
+	uint8_t dmloe = 0;
+	uint16_t citer_reg = EDMA_Model_dma.TCD[ch].CITER.ELINKNO;
+	uint8_t elink = (citer_reg & DMA_TCD_CITER_ELINKNO_ELINK_MASK) ? 1u : 0u;
+	uint16_t citer = elink ? (citer_reg & DMA_TCD_CITER_ELINKYES_CITER_LE_MASK)
+						   : (citer_reg & DMA_TCD_CITER_ELINKNO_CITER_MASK);
+	uint16_t biter_reg = EDMA_Model_dma.TCD[ch].BITER.ELINKNO;
+	uint16_t biter = elink ? (biter_reg & DMA_TCD_BITER_ELINKYES_BITER_MASK)
+						   : (biter_reg & DMA_TCD_BITER_ELINKNO_BITER_MASK);
+	uint16_t csr;
+	uint32_t moved;
+	uint32_t i;
+
+	if ((EDMA_Model_dma.CR & DMA_CR_EMLM_MASK) != 0u) {
+		smloe = (raw & DMA_TCD_NBYTES_MLOFFYES_SMLOE_MASK) ? 1u : 0u;
+		dmloe = (raw & DMA_TCD_NBYTES_MLOFFYES_DMLOE_MASK) ? 1u : 0u;
+		if (smloe || dmloe) {
+			nbytes = raw & DMA_TCD_NBYTES_MLOFFYES_NBYTES_MASK;
+			mloff = (int32_t)(raw << 2) >> 12;	/* MLOFF[29:10], sign extended */
+		}
+		else {
+			nbytes = raw & DMA_TCD_NBYTES_MLOFFNO_NBYTES_MASK;
+		}
+	}
+
+	/* Configuration errors, checked before anything is moved */
+	if ((nbytes == 0u) || ((nbytes % chunk) != 0u) || (citer == 0u) ||
+		(elink != ((biter_reg & DMA_TCD_BITER_ELINKNO_ELINK_MASK) ? 1u : 0u))) {
+		EDMA_error(ch, DMA_ES_NCE_MASK);
+		return;
+	}
+	if ((soff % (int32_t) sbytes) != 0) {
+		EDMA_error(ch, DMA_ES_SOE_MASK);
+		return;
+	}
+	if ((doff % (int32_t) dbytes) != 0) {
+		EDMA_error(ch, DMA_ES_DOE_MASK);
+		return;
+	}
+	if ((saddr & (sbytes - 1u)) != 0u) {
+		EDMA_error(ch, DMA_ES_SAE_MASK);
+		return;
+	}
+	if ((daddr & (dbytes - 1u)) != 0u) {
+		EDMA_error(ch, DMA_ES_DAE_MASK);
+		return;
+	}
+
+	csr = EDMA_Model_dma.TCD[ch].CSR;
+	csr &= (uint16_t) ~(DMA_TCD_CSR_START_MASK | DMA_TCD_CSR_DONE_MASK);
+	EDMA_Model_dma.TCD[ch].CSR = csr | DMA_TCD_CSR_ACTIVE_MASK;
+
+	/* Minor loop: reads of SSIZE and writes of DSIZE through a chunk buffer */
+	for (moved = 0; moved < nbytes; moved += chunk) {
+		for (i = 0; i < chunk; i += sbytes) {
+			if (!EDMA_mapped(saddr, sbytes)) {
+				EDMA_error(ch, DMA_ES_SBE_MASK);
+				return;
+			}
+			memcpy(&buffer[i], (const void *)(uintptr_t) saddr, sbytes);
+			stats->read_beats += (sbytes > 4u) ? (sbytes / 4u) : 1u;
+			saddr = EDMA_next(saddr, soff, smod);
+		}
+		for (i = 0; i < chunk; i += dbytes) {
+			if (!EDMA_mapped(daddr, dbytes)) {
+				EDMA_error(ch, DMA_ES_DBE_MASK);
+				return;
+			}
+			memcpy((void *)(uintptr_t) daddr, &buffer[i], dbytes);
+			stats->write_beats += (dbytes > 4u) ? (dbytes / 4u) : 1u;
+			daddr = EDMA_next(daddr, doff, dmod);
+		}
+	}
+	stats->bytes += nbytes;
+
+	/* Minor loop offset, applied after every minor loop */
+	if (smloe) {
+		saddr += (uint32_t) mloff;
+	}
+	if (dmloe) {
+		daddr += (uint32_t) mloff;
+	}
+
+	citer--;
+	csr = EDMA_Model_dma.TCD[ch].CSR & (uint16_t) ~DMA_TCD_CSR_ACTIVE_MASK;
+
+	if (citer != 0u) {
+		/* End of a minor loop */
+		EDMA_Model_dma.TCD[ch].SADDR = saddr;
+		EDMA_Model_dma.TCD[ch].DADDR = daddr;
+		EDMA_Model_dma.TCD[ch].CITER.ELINKNO = (uint16_t)((citer_reg & (elink ? ~DMA_TCD_CITER_ELINKYES_CITER_LE_MASK
+																			  : ~DMA_TCD_CITER_ELINKNO_CITER_MASK)) | citer);
+		EDMA_Model_dma.TCD[ch].CSR = csr;
+
+		if ((csr & DMA_TCD_CSR_INTHALF_MASK) && (citer == (biter >> 1))) {
+			EDMA_Model_dma.INT |= 1u << ch;
+			stats->interrupts++;
+		}
+		if (elink) {
+			stats->minor_links++;
+			EDMA_channel_start((uint8_t)((citer_reg & DMA_TCD_CITER_ELINKYES_LINKCH_MASK) >> DMA_TCD_CITER_ELINKYES_LINKCH_SHIFT));
+		}
+		return;
+	}
+
+	/* End of the major loop */
+	EDMA_major_count[ch]++;
+	csr |= DMA_TCD_CSR_DONE_MASK;
+	if (csr & DMA_TCD_CSR_INTMAJOR_MASK) {
+		EDMA_Model_dma.INT |= 1u << ch;
+		stats->interrupts++;
+	}
+	if (csr & DMA_TCD_CSR_DREQ_MASK) {
+		EDMA_Model_dma.ERQ &= ~(1u << ch);	/* Requests disabled after the major loop */
+	}
+
+	if (csr & DMA_TCD_CSR_ESG_MASK) {
+		uint32_t sga = EDMA_Model_dma.TCD[ch].DLASTSGA;
+		uint32_t tcd[8];
+
+		if ((sga & 0x1Fu) != 0u) {
+			EDMA_error(ch, DMA_ES_SGE_MASK);
+			return;
+		}
+		if (!EDMA_mapped(sga, sizeof(tcd))) {
+			EDMA_error(ch, DMA_ES_SBE_MASK);
+			return;
+		}
+		memcpy(tcd, (const void *)(uintptr_t) sga, sizeof(tcd));	/* Next TCD, DONE kept from this one */
+		memcpy((void *) &EDMA_Model_dma.TCD[ch], tcd, sizeof(tcd));
+		EDMA_Model_dma.TCD[ch].CSR |= DMA_TCD_CSR_DONE_MASK;
+		stats->tcd_beats += sizeof(tcd) / 4u;
+	}
+	else {
+		EDMA_Model_dma.TCD[ch].SADDR = saddr + EDMA_Model_dma.TCD[ch].SLAST;
+		EDMA_Model_dma.TCD[ch].DADDR = daddr + EDMA_Model_dma.TCD[ch].DLASTSGA;
+		EDMA_Model_dma.TCD[ch].CITER.ELINKNO = biter_reg;
+		EDMA_Model_dma.TCD[ch].CSR = csr;
+	}
+
+	if (csr & DMA_TCD_CSR_MAJORELINK_MASK) {
+		stats->major_links++;
+		EDMA_channel_start((uint8_t)((csr & DMA_TCD_CSR_MAJORLINKCH_MASK) >> DMA_TCD_CSR_MAJORLINKCH_SHIFT));
+	}
+}
+
+/* Channel link or software start: sets START, serviced by EDMA_run. */
+static void EDMA_channel_start(uint8_t ch)
+{
+	EDMA_Model_dma.TCD[ch].CSR |= DMA_TCD_CSR_START_MASK;
+}
+
+/* Fixed priority arbitration needs a different DCHPRI level per channel. */
+static uint8_t EDMA_priorities_unique(void)
+{
+	uint8_t ch;
+	uint8_t other;
+
+	for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+		for (other = ch + 1u; other < DMA_TCD_COUNT; other++) {
+			if (((EDMA_Model_dma.DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)] ^
+				  EDMA_Model_dma.DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(other)]) & DMA_DCHPRI_CHPRI_MASK) == 0u) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/*!
+ * Service the channels with START set until none is left, highest DCHPRI
+ * first. A request met with two channels on the same level is not served
+ * (ES[CPE]).
+ */
+static void EDMA_run(void)
+{
+	uint8_t ch;
+	int16_t best;
+	uint32_t prio;
+
+	for (;;) {
+		best = -1;
+		for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+			if ((EDMA_Model_dma.TCD[ch].CSR & DMA_TCD_CSR_START_MASK) &&
+				((EDMA_Model_dma.ERR & (1u << ch)) == 0u)) {
+				prio = EDMA_Model_dma.DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(ch)] & DMA_DCHPRI_CHPRI_MASK;
+				if ((best < 0) || (prio > (uint32_t) (EDMA_Model_dma.DCHPRI[FEATURE_DMA_CHN_TO_DCHPRI_INDEX(best)] & DMA_DCHPRI_CHPRI_MASK))) {
+					best = ch;
+				}
+			}
+		}
+		if (best < 0) {
+			return;
+		}
+		if (EDMA_priorities_unique() == 0u) {
+			EDMA_error((uint8_t) best, DMA_ES_CPE_MASK);
+			continue;
+		}
+		EDMA_service((uint8_t) best);
+		EDMA_Model_dma.TCD[best].CSR &= (uint16_t) ~DMA_TCD_CSR_START_MASK;
+	}
+}
+
+/*!
+ * Apply the command registers written by the driver since the last sync
+ * (clears before sets), then service the channels started by SSRT or by
+ * CSR[START].
+ */
+void EDMA_Model_sync(void)
+{
+	uint8_t ch;
+	uint8_t v;
+
+	v = EDMA_Model_dma.CERQ;
+	if (!(v & EDMA_NOP)) {
+		EDMA_Model_dma.ERQ &= (v & DMA_CERQ_CAER_MASK) ? 0u : ~(1u << (v & DMA_CERQ_CERQ_MASK));
+	}
+	v = EDMA_Model_dma.CEEI;
+	if (!(v & EDMA_NOP)) {
+		EDMA_Model_dma.EEI &= (v & DMA_CEEI_CAEE_MASK) ? 0u : ~(1u << (v & DMA_CEEI_CEEI_MASK));
+	}
+	v = EDMA_Model_dma.CINT;
+	if (!(v & EDMA_NOP)) {
+		EDMA_Model_dma.INT &= (v & DMA_CINT_CAIR_MASK) ? 0u : ~(1u << (v & DMA_CINT_CINT_MASK));
+	}
+	v = EDMA_Model_dma.CERR;
+	if (!(v & EDMA_NOP)) {
+		EDMA_Model_dma.ERR &= (v & DMA_CERR_CAEI_MASK) ? 0u : ~(1u << (v & DMA_CERR_CERR_MASK));
+	}
+	v = EDMA_Model_dma.CDNE;
+	if (!(v & EDMA_NOP)) {
+		for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+			if ((v & DMA_CDNE_CADN_MASK) || (ch == (v & DMA_CDNE_CDNE_MASK))) {
+				EDMA_Model_dma.TCD[ch].CSR &= (uint16_t) ~DMA_TCD_CSR_DONE_MASK;
+			}
+		}
+	}
+	v = EDMA_Model_dma.SERQ;
+	if (!(v & EDMA_NOP)) {
+		EDMA_Model_dma.ERQ |= (v & DMA_SERQ_SAER_MASK) ? 0xFu : (1u << (v & DMA_SERQ_SERQ_MASK));
+	}
+	v = EDMA_Model_dma.SEEI;
+	if (!(v & EDMA_NOP)) {
+		EDMA_Model_dma.EEI |= (v & DMA_SEEI_SAEE_MASK) ? 0xFu : (1u << (v & DMA_SEEI_SEEI_MASK));
+	}
+	v = EDMA_Model_dma.SSRT;
+	if (!(v & EDMA_NOP)) {
+		for (ch = 0; ch < DMA_TCD_COUNT; ch++) {
+			if ((v & DMA_SSRT_SAST_MASK) || (ch == (v & DMA_SSRT_SSRT_MASK))) {
+				EDMA_channel_start(ch);
+			}
+		}
+	}
+
+	EDMA_Model_dma.CEEI = EDMA_NOP;
+	EDMA_Model_dma.SEEI = EDMA_NOP;
+	EDMA_Model_dma.CERQ = EDMA_NOP;
+	EDMA_Model_dma.SERQ = EDMA_NOP;
+	EDMA_Model_dma.CDNE = EDMA_NOP;
+	EDMA_Model_dma.SSRT = EDMA_NOP;
+	EDMA_Model_dma.CERR = EDMA_NOP;
+	EDMA_Model_dma.CINT = EDMA_NOP;
+
+	EDMA_run();
+}
+
+/*!
+ * Hardware request of a peripheral to a channel. It is only serviced while
+ * the channel has its requests enabled (ERQ) and no error, and raises
+ * ES[CPE] if two channels share a DCHPRI level.
+ *
+ * @return 1 if the channel ran a minor loop
+ */
+uint8_t EDMA_Model_request(uint8_t ch)
+{
+	if (((EDMA_Model_dma.ERQ & (1u << ch)) == 0u) || ((EDMA_Model_dma.ERR & (1u << ch)) != 0u)) {
+		return 0;
+	}
+	if (EDMA_priorities_unique() == 0u) {
+		EDMA_error(ch, DMA_ES_CPE_MASK);
+		return 0;
+	}
+	EDMA_service(ch);
+	EDMA_run();
+	return 1;
+}
+
+/*!
+ * Software start of a channel (CSR[START]), e.g. for a channel only run by links.
+ */
+void EDMA_Model_start(uint8_t ch)
+{
+	EDMA_channel_start(ch);
+	EDMA_run();
+}
+
+/*! Counters of a channel since the last EDMA_Model_clear_stats. */
+const DMA_TCD_Stats_t * EDMA_Model_stats(uint8_t ch)
+{
+	return &EDMA_stats[ch];
+}
+
+void EDMA_Model_clear_stats(void)
+{
+	memset(EDMA_stats, 0, sizeof(EDMA_stats));
+	memset(EDMA_major_count, 0, sizeof(EDMA_major_count));
+}
+
+/*! Major loops completed by a channel since the last EDMA_Model_clear_stats. */
+uint32_t EDMA_Model_majors(uint8_t ch)
+{
+	return EDMA_major_count[ch];
+}
+
+/*! Channel errors since EDMA_Model_reset. */
+uint32_t EDMA_Model_errors(void)
+{
+	return EDMA_error_count;
+}
+
+/*! DEV_ASSERT failures since EDMA_Model_reset. */
+uint32_t EDMA_Model_asserts(void)
+{
+	return EDMA_assert_count;
+}
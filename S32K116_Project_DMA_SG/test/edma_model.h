@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EDMA_MODEL_H_
+#define EDMA_MODEL_H_
+
+/*!
+ * Host model of the eDMA
+ * ===================================================
+ * Runs the TCDs programmed by the dma driver on a PC, so TCD images and
+ * driver configurations can be checked without a board. The model covers the
+ * minor and major loops, SOFF/DOFF, SMOD/DMOD, NBYTES with minor loop
+ * offsets (EMLM), SLAST, DLASTSGA, Scatter Gather (ESG), minor (ELINK) and
+ * major (MAJORELINK) channel links, DREQ, INTHALF/INTMAJOR and the priority
+ * check of the arbitration (ES[CPE]). It counts what every channel moved in
+ * the same DMA_TCD_Stats_t terms as DMA_TCD_Stats: bytes, bus beats, TCD
+ * fetches, link events and interrupt requests.
+ *
+ * Force this file ahead of every source (cc -include edma_model.h), driver
+ * sources included: the peripheral pointers used by the driver (DMA, DMAMUX,
+ * ADC0, PCC, SIM, LPIT0) are redirected to host copies of the registers.
+ * The TCDs hold 32-bit addresses, so the checks are built for a 32-bit host
+ * (cc -m32).
+ *
+ * Limitations: requests are issued by the caller (EDMA_Model_request), the
+ * linked channels run right after the channel that linked them, highest
+ * DCHPRI first, and the write-only command registers (SERQ, CERQ, CINT...)
+ * are applied by EDMA_Model_sync, one write each since the previous sync.
+ */
+
+#define CUSTOM_DEVASSERT	"edma_devassert.h"	/* DEV_ASSERT failures are counted, not trapped */
+#include "device_registers.h"
+
+extern DMA_Type EDMA_Model_dma;
+extern DMAMUX_Type EDMA_Model_dmamux;
+extern ADC_Type EDMA_Model_adc0;
+extern PCC_Type EDMA_Model_pcc;
+extern SIM_Type EDMA_Model_sim;
+extern LPIT_Type EDMA_Model_lpit0;
+
+#undef DMA
+#undef DMAMUX
+#undef ADC0
+#undef PCC
+#undef SIM
+#undef LPIT0
+#define DMA		(&EDMA_Model_dma)
+#define DMAMUX	(&EDMA_Model_dmamux)
+#define ADC0	(&EDMA_Model_adc0)
+#define PCC		(&EDMA_Model_pcc)
+#define SIM		(&EDMA_Model_sim)
+#define LPIT0	(&EDMA_Model_lpit0)
+
+#include "dma.h"
+
+#define EDMA_MODEL_REGIONS	16	/* Memory blocks the channels may access */
+
+void EDMA_Model_reset(void);
+void EDMA_Model_region(const volatile void * base, uint32_t size);
+void EDMA_Model_sync(void);
+uint8_t EDMA_Model_request(uint8_t ch);
+void EDMA_Model_start(uint8_t ch);
+const DMA_TCD_Stats_t * EDMA_Model_stats(uint8_t ch);
+void EDMA_Model_clear_stats(void);
+uint32_t EDMA_Model_majors(uint8_t ch);
+uint32_t EDMA_Model_errors(void);
+uint32_t EDMA_Model_asserts(void);
+
+#endif /* EDMA_MODEL_H_ */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2018, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "device_registers.h"								/* include peripheral declarations */
+#include "LPIT.h"
+
+/*!
+* @brief LPIT0 Initialization of a periodic tick on channel LPIT_PERIOD_CH,
+* polled with LPIT0_period_wait (no interrupt).
+*
+* @param[uint32_t period_us] Period of the tick in microseconds
+*/
+void LPIT0_period_init (uint32_t period_us)
+{
+	/* Module Configuration */
+	PCC -> PCCn[PCC_LPIT_INDEX] = PCC_PCCn_PCS(2);    		/* Clock Source = 2 (SIRCDIV2_CLK = 8 MHz) */
+	PCC -> PCCn[PCC_LPIT_INDEX] |= PCC_PCCn_CGC_MASK; 		/* Enable CLK for LPIT registers */
+
+	LPIT0 -> MCR |= LPIT_MCR_M_CEN_MASK;  					/* DBG_EN = 0: Timer channels stop in Debug mode */
+															/* M_CEN = 1: Enable module clock (allows writing other LPIT0 registers) */
+
+	/* LPIT0 Channel Configuration */
+	LPIT0 -> TMR[LPIT_PERIOD_CH].TVAL = (period_us * (LPIT_CLK_HZ / 1000000u)) - 1u;	/* Timeout Period = (TVAL + 1) / 8 MHz */
+	LPIT0 -> MSR = LPIT_MSR_TIF0_MASK << LPIT_PERIOD_CH;		/* Clear any pending timeout */
+	LPIT0 -> TMR[LPIT_PERIOD_CH].TCTRL = LPIT_TMR_TCTRL_T_EN_MASK;	/* T_EN = 1: Timer channel is enabled */
+															/* MODE = 0: 32 Periodic counter mode */
+}
+
+/*!
+* @brief Wait for the next tick of LPIT0_period_init. The timer keeps running
+* while the caller works, so the period does not depend on the work time as
+* long as the work fits in one period.
+*/
+void LPIT0_period_wait (void)
+{
+	while ((LPIT0 -> MSR & (LPIT_MSR_TIF0_MASK << LPIT_PERIOD_CH)) == 0u) {}
+	LPIT0 -> MSR = LPIT_MSR_TIF0_MASK << LPIT_PERIOD_CH;		/* TIF is cleared writing 1 */
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2019, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "device_registers.h"
+#include "TOUCH.h"
+#include "TOUCH1.h"
+#include "ADC.h"
+
+static const TOUCH_Electrode_t *TOUCH_table;	// Electrodes of TOUCH_init
+static uint8_t TOUCH_count = 0;
+static uint8_t TOUCH_baseline_valid = 0;		// TOUCH_state initialized from a first scan
+static TOUCH_State_t TOUCH_states[TOUCH_ELECTRODES_MAX];
+static uint16_t TOUCH_sample_delay = 0;			// TOUCH_delay loops of the ADC sample phase, 0: wait for the conversion
+
+/*****************************************************************************
+*
+* Function: static void TOUCH_distribute (const TOUCH_Electrode_t *elec)
+* Description: Charge distribution, electrode low and Cext high
+*
+*****************************************************************************/
+static void TOUCH_distribute (const TOUCH_Electrode_t *elec)
+{
+	// Drive electrode GPIO low and Cext GPIO high
+	elec->gpio->PCOR = 1u << elec->elec_pin;
+	elec->gpio->PSOR = 1u << elec->cext_pin;
+
+	// Configure Electrode and Cext pins as GPIO to precharge them
+	elec->port->PCR[elec->elec_pin] = PCR_GPIO1;
+	elec->port->PCR[elec->cext_pin] = PCR_GPIO1;
+
+	// Configure Electrode and Cext pins as outputs at the same time
+	elec->gpio->PDDR |= (1u << elec->elec_pin) | (1u << elec->cext_pin);
+}
+
+/*****************************************************************************
+*
+* Function: static void TOUCH_redistribute (const TOUCH_Electrode_t *elec)
+* Description: Charge redistribution, also leaves the electrode floating
+*
+*****************************************************************************/
+static void TOUCH_redistribute (const TOUCH_Electrode_t *elec)
+{
+	// Configure Electrode and Cext pins as inputs at the same time
+	elec->gpio->PDDR &= ~((1u << elec->elec_pin) | (1u << elec->cext_pin));
+}
+
+/*****************************************************************************
+*
+* Function: static void TOUCH_delay (uint16_t loops)
+* Description: Delay to distribute charge
+*
+*****************************************************************************/
+static void TOUCH_delay (uint16_t loops)
+{
+	volatile uint16_t tmp = loops;
+	while (tmp) {tmp--;}
+}
+
+/*****************************************************************************
+*
+* Function: static uint16_t TOUCH_sample_loops (void)
+* Description: TOUCH_delay loops covering the sample phase of ADC0, from its
+* clock source (PCC), SOSCDIV2, ADIV and SMPLTS as they are configured. The
+* input is sampled again for each averaged conversion, so with hardware
+* averaging, another clock source than SOSCDIV2 or a phase longer than the
+* loop counter, the next electrode waits for the end of the conversion.
+*
+* Return: loops, 0 to wait for the conversion
+*
+*****************************************************************************/
+static uint16_t TOUCH_sample_loops (void)
+{
+	uint32_t soscdiv2 = (SCG->SOSCDIV & SCG_SOSCDIV_SOSCDIV2_MASK) >> SCG_SOSCDIV_SOSCDIV2_SHIFT;
+	uint32_t adiv = (ADC0->CFG1 & ADC_CFG1_ADIV_MASK) >> ADC_CFG1_ADIV_SHIFT;
+	uint32_t sample_clks = ((ADC0->CFG2 & ADC_CFG2_SMPLTS_MASK) >> ADC_CFG2_SMPLTS_SHIFT) + 1u;
+	uint32_t adck_hz;
+	uint32_t loops;
+
+	if ((((PCC->PCCn[PCC_ADC0_INDEX] & PCC_PCCn_PCS_MASK) >> PCC_PCCn_PCS_SHIFT) != 1u)
+		|| (soscdiv2 == 0u) || ((ADC0->SC3 & ADC_SC3_AVGE_MASK) != 0u))
+	{
+		return 0;
+	}
+
+	// SOSCDIV2 = 1..7: divide by 1..64, ADIV: divide by 1..8
+	adck_hz = (TOUCH_SOSC_HZ >> (soscdiv2 - 1u)) >> adiv;
+	loops = ((sample_clks * (TOUCH_CORE_HZ / 1000u)) / (adck_hz / 1000u) + TOUCH_DELAY_LOOP_CLKS - 1u) / TOUCH_DELAY_LOOP_CLKS;
+
+	return (loops > 0xFFFFu) ? 0u : (uint16_t) loops;
+}
+
+/*****************************************************************************
+*
+* Function: void TOUCH_init (const TOUCH_Electrode_t *table, uint8_t count)
+* Description: Select the electrodes to scan and leave them floating. The
+* table must stay valid while scanning. ADC0 must be initialized for SW
+* trigger (ADC_init) before, and TOUCH_init called again when its clock or
+* timing changes (ADC_Timing_config): the sample phase is read from it here.
+*
+*****************************************************************************/
+void TOUCH_init (const TOUCH_Electrode_t *table, uint8_t count)
+{
+	uint8_t i;
+
+	if (count > TOUCH_ELECTRODES_MAX)
+	{
+		count = TOUCH_ELECTRODES_MAX;
+	}
+	TOUCH_table = table;
+	TOUCH_count = count;
+	TOUCH_baseline_valid = 0;
+	TOUCH_sample_delay = TOUCH_sample_loops();
+
+	for (i = 0; i < count; i++)
+	{
+		// Enable clock for the PORT of the electrode (PORTA to PORTE are consecutive)
+		PCC->PCCn[PCC_PORTA_INDEX + (((uint32_t) table[i].port - PORTA_BASE) >> 12)] |= PCC_PCCn_CGC_MASK;
+		TOUCH_redistribute(&table[i]);
+	}
+}
+
+/*****************************************************************************
+*
+* Function: void TOUCH_scan (uint16_t *results)
+* Description: Sense all the electrodes, one result (mV) per electrode.
+* The steps are pipelined: while the ADC converts the Cext voltage of one
+* electrode, the charge of the next one is being distributed, so a scan
+* costs about one charge delay (or one conversion, the longest) per
+* electrode instead of both. Each electrode keeps its own pins, but the
+* switching of the next distribution couples into the Cext voltage while the
+* ADC samples it: the next electrode is only distributed after the sample
+* phase (SMPLTS + 1 ADC clocks, TOUCH_sample_loops), during the conversion
+* phase, which no longer reads the input.
+*
+*****************************************************************************/
+void TOUCH_scan (uint16_t *results)
+{
+	uint8_t i;
+
+	if (TOUCH_count == 0)
+	{
+		return;
+	}
+
+	// Distribute the charge of the first electrode
+	TOUCH_distribute(&TOUCH_table[0]);
+	TOUCH_delay(TOUCH_table[0].dist_charge_delay);
+
+	for (i = 0; i < TOUCH_count; i++)
+	{
+		// Start Cext voltage ADC conversion, sampled during the redistribution
+		ADC_channel_convert(TOUCH_table[i].adc_channel);
+		TOUCH_redistribute(&TOUCH_table[i]);
+
+		// Distribute the next electrode while converting, once the input is sampled
+		if ((i + 1u) < TOUCH_count)
+		{
+			if (TOUCH_sample_delay != 0u)
+			{
+				TOUCH_delay(TOUCH_sample_delay);
+			}
+			else
+			{
+				while(ADC_conversion_complete()==0){}
+			}
+			TOUCH_distribute(&TOUCH_table[i + 1u]);
+			TOUCH_delay(TOUCH_table[i + 1u].dist_charge_delay);
+		}
+
+		// Equivalent voltage digitalization
+		while(ADC_conversion_complete()==0){}
+		results[i] = (uint16_t) ADC_channel_read();
+	}
+}
+
+/*****************************************************************************
+*
+* Function: uint32_t TOUCH_touched (const uint16_t *results)
+* Description: Compare the results of TOUCH_scan with the touched limits
+*
+* Return: bit i set when electrode i is touched
+*
+*****************************************************************************/
+uint32_t TOUCH_touched (const uint16_t *results)
+{
+	uint32_t touched = 0;
+	uint8_t i;
+
+	for (i = 0; i < TOUCH_count; i++)
+	{
+		if (results[i] < TOUCH_table[i].touched_limit)
+		{
+			touched |= 1u << i;
+		}
+	}
+
+	return touched;
+}
+
+/*****************************************************************************
+*
+* Function: uint32_t TOUCH_process (const uint16_t *results)
+* Description: Touch detection of the results of TOUCH_scan, relative to an
+* adaptive baseline instead of a fixed limit:
+*   - Baseline: IIR of the untouched results, it follows the temperature and
+*     supply drift. It is frozen while touched or while a touch is being
+*     debounced, and follows faster when the result rises above it.
+*   - Hysteresis: touched when the result drops touch_delta below the
+*     baseline, released when the drop is back under release_delta.
+*   - Debounce: the state changes after TOUCH_DEBOUNCE_MS against it.
+*   - A touch longer than TOUCH_STUCK_S is taken as a drift: the baseline
+*     restarts from the result and the electrode is released.
+* Times are counted in scans, so it must be called every TOUCH_SCAN_PERIOD_MS.
+* Only adds and shifts, the scan time is not changed.
+*
+* Return: bit i set when electrode i is touched
+*
+*****************************************************************************/
+uint32_t TOUCH_process (const uint16_t *results)
+{
+	uint32_t touched = 0;
+	TOUCH_State_t *state;
+	int32_t delta;
+	uint8_t candidate;
+	uint8_t i;
+
+	for (i = 0; i < TOUCH_count; i++)
+	{
+		state = &TOUCH_states[i];
+
+		if (TOUCH_baseline_valid == 0)
+		{
+			state->baseline = (uint32_t) results[i] << TOUCH_BASELINE_FRAC;
+			state->touched_scans = 0;
+			state->debounce = 0;
+			state->touched = 0;
+		}
+
+		// Drop of the result below the baseline (mV)
+		delta = (int32_t)(state->baseline >> TOUCH_BASELINE_FRAC) - (int32_t) results[i];
+
+		if (state->touched)
+		{
+			candidate = (delta >= (int32_t) TOUCH_table[i].release_delta) ? 1u : 0u;
+		}
+		else
+		{
+			candidate = (delta >= (int32_t) TOUCH_table[i].touch_delta) ? 1u : 0u;
+		}
+
+		// Debounce
+		if (candidate != state->touched)
+		{
+			if (++state->debounce >= TOUCH_DEBOUNCE)
+			{
+				state->touched = candidate;
+				state->debounce = 0;
+				state->touched_scans = 0;
+			}
+		}
+		else
+		{
+			state->debounce = 0;
+		}
+
+		if (state->touched)
+		{
+			if (++state->touched_scans >= TOUCH_STUCK_SCANS)
+			{
+				// Drift, not a finger: new baseline
+				state->baseline = (uint32_t) results[i] << TOUCH_BASELINE_FRAC;
+				state->touched = 0;
+				state->touched_scans = 0;
+			}
+		}
+		else if (state->debounce == 0)
+		{
+			// Baseline tracking, untouched and no touch being debounced
+			delta = ((int32_t) results[i] << TOUCH_BASELINE_FRAC) - (int32_t) state->baseline;
+			state->baseline += (uint32_t)(delta >> ((delta > 0) ? TOUCH_IIR_FAST_SHIFT : TOUCH_IIR_SHIFT));
+		}
+
+		if (state->touched)
+		{
+			touched |= 1u << i;
+		}
+	}
+
+	TOUCH_baseline_valid = 1;
+
+	return touched;
+}
+
+/*****************************************************************************
+*
+* Function: const TOUCH_State_t * TOUCH_state (uint8_t electrode)
+* Description: Processing state of one electrode, e.g. to tune the deltas
+*
+* Return: 0 when the electrode is not in the table of TOUCH_init
+*
+*****************************************************************************/
+const TOUCH_State_t * TOUCH_state (uint8_t electrode)
+{
+	if (electrode >= TOUCH_count)
+	{
+		return 0;
+	}
+	return &TOUCH_states[electrode];
+}
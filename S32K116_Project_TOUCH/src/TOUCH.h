@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2014 - 2016, Freescale Semiconductor, Inc.
+ * Copyright (c) 2016 - 2019, NXP.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NXP "AS IS" AND ANY EXPRESSED OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL NXP OR ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef TOUCH_H_
+#define TOUCH_H_
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "device_registers.h"
+
+#define TOUCH_ELECTRODES_MAX	32		// One bit per electrode in TOUCH_touched
+
+/*******************************************************************************
+* Sample phase of the ADC, the next electrode is not switched before its end
+******************************************************************************/
+#define TOUCH_CORE_HZ			48000000u	// Fastest core clock (RUN_mode_48MHz), a slower core only waits longer
+#define TOUCH_SOSC_HZ			8000000u	// SOSC_init_40MHz: 8 MHz crystal, SOSCDIV2 divides it
+#define TOUCH_DELAY_LOOP_CLKS	4u			// Fewest core clocks of one TOUCH_delay loop
+
+/*******************************************************************************
+* TOUCH_process: baseline and debounce, fixed point, once per scan. The scans
+* must be paced every TOUCH_SCAN_PERIOD_MS (e.g. LPIT0_period_wait), the
+* debounce and the stuck timeout are times converted to scans.
+******************************************************************************/
+#define TOUCH_SCAN_PERIOD_MS	5		// Period of TOUCH_scan + TOUCH_process
+#define TOUCH_BASELINE_FRAC		8		// Fraction bits of the baseline (mV)
+#define TOUCH_IIR_SHIFT			6		// Baseline follows the result by 1/64 per scan (0.3 s time constant)
+#define TOUCH_IIR_FAST_SHIFT	2		// 1/4 when the result is above the baseline
+#define TOUCH_DEBOUNCE_MS		15		// Time against the current state to change it
+#define TOUCH_STUCK_S			20		// Touched longer than this: new baseline, released
+
+#define TOUCH_DEBOUNCE			((TOUCH_DEBOUNCE_MS + TOUCH_SCAN_PERIOD_MS - 1) / TOUCH_SCAN_PERIOD_MS)
+#define TOUCH_STUCK_SCANS		((TOUCH_STUCK_S * 1000uL) / TOUCH_SCAN_PERIOD_MS)
+
+/*******************************************************************************
+* Electrode table entry
+******************************************************************************/
+typedef struct
+{
+	PORT_Type *port;			// PORT of the electrode and Cext pins
+	GPIO_Type *gpio;			// GPIO of the same port
+	uint8_t elec_pin;			// Electrode pin
+	uint8_t cext_pin;			// Cext pin, also the ADC input
+	uint8_t adc_channel;		// ADC0 channel of the Cext pin
+	uint16_t dist_charge_delay;	// Loops to distribute the charge
+	uint16_t touched_limit;		// Touched below this result (mV), TOUCH_touched
+	uint16_t touch_delta;		// Touched when the result drops this much below the baseline (mV)
+	uint16_t release_delta;		// Released when the drop is back under this (mV), < touch_delta
+}TOUCH_Electrode_t;
+
+/*******************************************************************************
+* Electrode processing state
+******************************************************************************/
+typedef struct
+{
+	uint32_t baseline;			// Untouched result, mV with TOUCH_BASELINE_FRAC fraction bits
+	uint32_t touched_scans;		// Scans since the touch was detected
+	uint8_t debounce;			// Consecutive scans against the current state
+	uint8_t touched;			// Debounced state
+}TOUCH_State_t;
+
+/*******************************************************************************
+* Function prototypes
+******************************************************************************/
+void TOUCH_init (const TOUCH_Electrode_t *table, uint8_t count);
+void TOUCH_scan (uint16_t *results);
+uint32_t TOUCH_touched (const uint16_t *results);
+uint32_t TOUCH_process (const uint16_t *results);
+const TOUCH_State_t * TOUCH_state (uint8_t electrode);
+
+#endif /* TOUCH_H_ */
@@ -40,6 +40,8 @@
 ******************************************************************************/
 #define ELEC1_TOUCHED_LIMIT_VALUE   (2000)
 #define ELEC1_DIST_CHARGE_DELAY     (100)
+#define ELEC1_TOUCH_DELTA           (300)	// Drop below the baseline (mV) to detect a touch
+#define ELEC1_RELEASE_DELTA         (150)	// Drop below the baseline (mV) to keep it touched
 
 /*******************************************************************************
 * PCR defines
@@ -35,17 +35,27 @@
 #include "device_registers.h"
 #include "clocks_and_modes_S32K11x.h"
 #include "TOUCH1.h"
+#include "TOUCH.h"
 #include "ADC.h"
-#include <stdbool.h>
+#include "LPIT.h"
 
 #define PTE8 (8)   	/* Port E8: FRDM EVB output to blue LED 	*/
 #define PTD16 (16)	/* Port D16: FRDM EVB output to red LED 	*/
 #define PTD15 (15) 	/* Port D15: FRDM EVB output to green LED 	*/
 
 /*******************************************************************************
-* Function prototypes
+* Electrodes, add one entry per pad
 ******************************************************************************/
-bool TouchSense1 (void);
+#define ELECTRODES	1
+
+const TOUCH_Electrode_t Electrodes[ELECTRODES] =
+{
+	{ELEC1_PORT, ELEC1_GPIO, ELEC1_ELEC_GPIO_PIN, ELEC1_CEXT_GPIO_PIN, ELEC1_ADC_CHANNEL,
+	 ELEC1_DIST_CHARGE_DELAY, ELEC1_TOUCHED_LIMIT_VALUE,
+	 ELEC1_TOUCH_DELTA, ELEC1_RELEASE_DELTA},					/* PAD1 (SW7) */
+};
+
+uint16_t TouchResults[ELECTRODES];	/* Last scan, mV per electrode */
 
 /*****************************************************************************
 *
@@ -108,14 +118,17 @@ int main(void)
     PORT_init();		   /* Init  port clocks and gpio outputs 						*/
     ADC_init();            /* Init ADC resolution 12 bit								*/
 
-    /* Enable clock for PORTC */
-    PCC->PCCn[PCC_PORTC_INDEX ]|=PCC_PCCn_CGC_MASK;
+    TOUCH_init(Electrodes, ELECTRODES);	/* Enable the electrode port clocks, electrodes floating */
+    LPIT0_period_init(TOUCH_SCAN_PERIOD_MS * 1000u);	/* Scan period, TOUCH_process counts time in scans */
 
     /* Endless loop */
     for(;;)
     {
+    	LPIT0_period_wait();	/* One scan every TOUCH_SCAN_PERIOD_MS */
+    	TOUCH_scan(TouchResults);
+
     	/* If PAD1 is touched, Blue led turns on */
-    	if(TouchSense1())
+    	if(TOUCH_process(TouchResults) & (1u << 0))	/* Baseline, hysteresis and debounce */
     	{
     		PTE ->PCOR |= 1 << PTE8;
     	}
@@ -127,45 +140,3 @@ int main(void)
 
     return 0;
 }
-
-/*****************************************************************************
-*
-* Function: bool TouchSense1 (void)
-* Description: Sense pad1
-*
-*****************************************************************************/
-bool TouchSense1 (void)
-{
-	bool Touched = false;
-	uint16_t adcResult;
-	uint32_t chargeDistributionPeriodTmp = ELEC1_DIST_CHARGE_DELAY;
-
-	// Configure touch button (and EGS) electrodes floating
-	ElectrodeFloat1();
-
-	// Distribute Electrode and Cext charge
-	ChargeDistribution1();
-
-	// Delay to distribute charge
-	while (chargeDistributionPeriodTmp) {chargeDistributionPeriodTmp--;}
-
-	// Start Cext voltage ADC conversion
-	ADC_channel_convert(ELEC1_ADC_CHANNEL);
-
-	// Redistribute Electrode and Cext charge
-	ChargeRedistribution1();
-
-	// Equivalent voltage digitalization
-	// Wait for conversion complete flag
-	while(ADC_conversion_complete()==0){}
-	adcResult = ADC_channel_read();
-	(void)adcResult;
-
-	// Compare with the Touched reference.
-	if(ADC_channel_read() < ELEC1_TOUCHED_LIMIT_VALUE)
-	{
-		Touched = true;
-	}
-
-	return Touched;
-}